@@ -0,0 +1,125 @@
+#include <Limbs.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using lab::Limb;
+
+/**
+ * @brief Keeps compiler from merging or dropping calls, whose results only go to memory
+ */
+inline void clobberMemory() {
+    __asm__ volatile("" : : : "memory");
+}
+
+/**
+ * @brief Carry loop in plain C++, the way carries were propagated before the mpn layer
+ */
+inline Limb portableAdd(Limb* result, const Limb* lhs, const Limb* rhs, std::size_t size) {
+    Limb carry = 0;
+    for (std::size_t i = 0; i < size; ++i) {
+        const Limb sum = lhs[i] + rhs[i] + carry;
+        carry = (sum < lhs[i]) || (sum == lhs[i] && carry != 0);
+        result[i] = sum;
+    }
+    return carry;
+}
+
+inline Limb portableSub(Limb* result, const Limb* lhs, const Limb* rhs, std::size_t size) {
+    Limb borrow = 0;
+    for (std::size_t i = 0; i < size; ++i) {
+        const Limb left = lhs[i];
+        const Limb right = rhs[i];
+        result[i] = left - right - borrow;
+        borrow = (left < right) || (left == right && borrow != 0);
+    }
+    return borrow;
+}
+
+/**
+ * @return Best of several runs of time of a single call in nanoseconds per limb
+ */
+template <typename Operation>
+double nanosPerLimb(const Operation& operation, std::size_t size) {
+    using Clock = std::chrono::steady_clock;
+    // calls on short spans are shorter than reading the clock, so it is read once per batch
+    const std::size_t batch = std::max<std::size_t>(1, 4096 / size);
+
+    double best = std::numeric_limits<double>::max();
+    for (int run = 0; run < 5; ++run) {
+        std::size_t repeats = 0;
+        const auto start = Clock::now();
+        std::chrono::duration<double> elapsed{};
+        do {
+            for (std::size_t i = 0; i < batch; ++i) {
+                operation();
+                clobberMemory();
+            }
+            repeats += batch;
+            elapsed = Clock::now() - start;
+        } while (elapsed.count() < 0.01);
+        best = std::min(best, elapsed.count() / repeats);
+    }
+    return best * 1e9 / size;
+}
+
+/**
+ * @brief Prints times of operation on each of sizes in a row of the table
+ */
+template <typename Operation>
+void report(const std::string& name, const std::vector<std::size_t>& sizes, const Operation& operation) {
+    std::cout << std::left << std::setw(14) << name << std::right;
+    for (const auto size : sizes) {
+        std::cout << std::setw(12) << nanosPerLimb([&operation, size] { operation(size); }, size);
+    }
+    std::cout << std::endl;
+}
+
+} // namespace
+
+/**
+ * @brief Times primitives of Limbs.hpp on spans of a few sizes, add_n and sub_n next to
+ *        plain C++ carry loops, which they replace. Numbers make sense in Release builds only
+ */
+int main() {
+    const std::vector<std::size_t> sizes{8, 64, 1024};
+
+    std::mt19937_64 generator(18);
+    std::vector<Limb> lhs(sizes.back());
+    std::vector<Limb> rhs(sizes.back());
+    std::vector<Limb> result(sizes.back());
+    std::generate(lhs.begin(), lhs.end(), std::ref(generator));
+    std::generate(rhs.begin(), rhs.end(), std::ref(generator));
+    const Limb factor = generator();
+    const Limb divisor = generator() | 1;
+    Limb* out = result.data();
+    const Limb* left = lhs.data();
+    const Limb* right = rhs.data();
+
+    std::cout << "Nanoseconds per limb, best of five runs\n" << std::setw(14) << "";
+    for (const auto size : sizes) {
+        std::cout << std::setw(12) << (std::to_string(size) + " limbs");
+    }
+    std::cout << "\n" << std::fixed << std::setprecision(2);
+
+    report("portable add", sizes, [=](std::size_t size) { portableAdd(out, left, right, size); });
+    report("add_n", sizes, [=](std::size_t size) { lab::mpn::add_n(out, left, right, size); });
+    report("portable sub", sizes, [=](std::size_t size) { portableSub(out, left, right, size); });
+    report("sub_n", sizes, [=](std::size_t size) { lab::mpn::sub_n(out, left, right, size); });
+    report("mul_1", sizes, [=](std::size_t size) { lab::mpn::mul_1(out, left, size, factor); });
+    report("addmul_1", sizes, [=](std::size_t size) { lab::mpn::addmul_1(out, left, size, factor); });
+    report("submul_1", sizes, [=](std::size_t size) { lab::mpn::submul_1(out, left, size, factor); });
+    report("lshift", sizes, [=](std::size_t size) { lab::mpn::lshift(out, left, size, 13); });
+    report("rshift", sizes, [=](std::size_t size) { lab::mpn::rshift(out, left, size, 13); });
+    report("divrem_1", sizes, [=](std::size_t size) { lab::mpn::divrem_1(out, left, size, divisor); });
+    report("mod_1", sizes, [=](std::size_t size) { *out = lab::mpn::mod_1(left, size, divisor); });
+    return 0;
+}
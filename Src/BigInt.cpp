@@ -0,0 +1,142 @@
+#include <BigInt.hpp>
+
+namespace lab {
+
+BigInt::BigInt(const BigNum& magnitude, bool negative)
+    : _magnitude(magnitude)
+    , _negative(negative) {
+    _normalize();
+}
+
+BigInt::BigInt(BigNum&& magnitude, bool negative)
+    : _magnitude(std::move(magnitude))
+    , _negative(negative) {
+    _normalize();
+}
+
+BigInt::BigInt(std::string_view num_str) {
+    _negative = !num_str.empty() && num_str.front() == '-';
+    _magnitude = BigNum(_negative ? num_str.substr(1) : num_str);
+    _normalize();
+}
+
+std::string to_string(const BigInt& num)
+{
+    return num._negative ? "-" + to_string(num._magnitude) : to_string(num._magnitude);
+}
+
+const BigNum& BigInt::magnitude() const {
+    return _magnitude;
+}
+
+bool BigInt::isNegative() const {
+    return _negative;
+}
+
+void BigInt::_normalize() {
+    if (_magnitude == BigNum()) {
+        _negative = false;
+    }
+}
+
+bool operator<(const BigInt& left, const BigInt& right) {
+    if (left._negative != right._negative) return left._negative;
+    return left._negative ? right._magnitude < left._magnitude
+                          : left._magnitude < right._magnitude;
+}
+
+bool operator>(const BigInt& left, const BigInt& right) {
+    return (right < left);
+}
+
+bool operator<=(const BigInt& left, const BigInt& right) {
+    return !(right < left);
+}
+
+bool operator>=(const BigInt& left, const BigInt& right) {
+    return !(left < right);
+}
+
+bool operator==(const BigInt& left, const BigInt& right) {
+    return left._negative == right._negative && left._magnitude == right._magnitude;
+}
+
+bool operator!=(const BigInt& left, const BigInt& right) {
+    return !(left == right);
+}
+
+BigInt operator-(const BigInt& num) {
+    return BigInt(num._magnitude, !num._negative);
+}
+
+BigInt& BigInt::operator+=(const BigInt& other) {
+    if (_negative == other._negative) {
+        _magnitude += other._magnitude;
+    } else if (_magnitude >= other._magnitude) {
+        _magnitude -= other._magnitude;
+    } else {
+        _magnitude = other._magnitude - std::move(_magnitude);
+        _negative = other._negative;
+    }
+    _normalize();
+    return *this;
+}
+
+BigInt& BigInt::operator-=(const BigInt& other) {
+    if (this == &other) {
+        *this = BigInt();
+        return *this;
+    }
+    _negative = !_negative;
+    *this += other;
+    _negative = !_negative;
+    _normalize();
+    return *this;
+}
+
+BigInt& BigInt::operator*=(const BigInt& other) {
+    _magnitude *= other._magnitude;
+    _negative = _negative != other._negative;
+    _normalize();
+    return *this;
+}
+
+BigInt operator+(const BigInt& left, const BigInt& right) {
+    BigInt result = left;
+    result += right;
+    return result;
+}
+
+BigInt operator-(const BigInt& left, const BigInt& right) {
+    BigInt result = left;
+    result -= right;
+    return result;
+}
+
+BigInt operator*(const BigInt& left, const BigInt& right) {
+    return BigInt(left._magnitude * right._magnitude, left._negative != right._negative);
+}
+
+std::pair<BigInt, BigInt> extract(const BigInt& first, const BigInt& second) {
+    auto [int_part, remainder] = extract(first._magnitude, second._magnitude);
+    return std::pair(BigInt(std::move(int_part), first._negative != second._negative),
+                     BigInt(std::move(remainder), first._negative));
+}
+
+BigInt operator/(const BigInt& left, const BigInt& right) {
+    return extract(left, right).first;
+}
+
+BigInt operator%(const BigInt& left, const BigInt& right) {
+    return extract(left, right).second;
+}
+
+BigNum residue(const BigInt& num, BigNumView mod) {
+    BigNum result = num._magnitude % mod;
+    if (num._negative && result != BigNum()) {
+        result = mod - std::move(result);
+    }
+    return result;
+}
+
+} // namespace lab
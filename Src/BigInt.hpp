@@ -0,0 +1,88 @@
+#pragma once
+
+#include <BigNum.hpp>
+
+namespace lab {
+
+/**
+ * @brief Class for holding big signed integers as sign and BigNum magnitude
+ */
+class BigInt
+{
+public:
+    BigInt() = default;
+
+    explicit BigInt(const BigNum& magnitude, bool negative = false);
+
+    explicit BigInt(BigNum&& magnitude, bool negative = false);
+
+    /**
+     * @param num_str decimal number with optional leading minus
+     */
+    explicit BigInt(std::string_view num_str);
+
+    friend std::string to_string(const BigInt& num);
+
+    const BigNum& magnitude() const;
+
+    bool isNegative() const;
+
+    friend bool operator<(const BigInt& left, const BigInt& right);
+    friend bool operator<=(const BigInt& left, const BigInt& right);
+    friend bool operator>(const BigInt& left, const BigInt& right);
+    friend bool operator>=(const BigInt& left, const BigInt& right);
+    friend bool operator==(const BigInt& left, const BigInt& right);
+    friend bool operator!=(const BigInt& left, const BigInt& right);
+
+    friend BigInt operator-(const BigInt& num);
+
+    friend BigInt operator+(const BigInt& left, const BigInt& right);
+    friend BigInt operator-(const BigInt& left, const BigInt& right);
+    friend BigInt operator*(const BigInt& left, const BigInt& right);
+
+    /**
+     * @brief Division rounding towards zero
+     */
+    friend BigInt operator/(const BigInt& left, const BigInt& right);
+
+    /**
+     * @note Remainder has the same sign as left number
+     */
+    friend BigInt operator%(const BigInt& left, const BigInt& right);
+
+    BigInt& operator+=(const BigInt& other);
+    BigInt& operator-=(const BigInt& other);
+    BigInt& operator*=(const BigInt& other);
+
+    /**
+     * @brief Division rounding towards zero
+     * @return Pair of numbers, the first is an integer, the second is a remainder of division
+     */
+    friend std::pair<BigInt, BigInt> extract(const BigInt& first, const BigInt& second);
+
+    /**
+     * @return Number from [0, mod) corresponding to num in group modulo mod
+     */
+    friend BigNum residue(const BigInt& num, BigNumView mod);
+
+    template<typename OStream>
+    friend OStream& operator<<(OStream& os, const BigInt& num);
+
+private:
+    /**
+     * @brief Zero is always kept non-negative
+     */
+    void _normalize();
+
+    BigNum _magnitude;
+    bool _negative = false;
+};
+
+template<typename OStream>
+OStream& operator<<(OStream& os, const BigInt& num)
+{
+    os << to_string(num);
+    return os;
+}
+
+} // namespace lab
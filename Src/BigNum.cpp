@@ -1,55 +1,244 @@
 #include <BigNum.hpp>
+#include <BigInt.hpp>
+#include <Limbs.hpp>
+#include <LimbKernels.hpp>
+#include <Thresholds.hpp>
+#include <ThreadPool.hpp>
 
-#include <iterator>
+#include <cstdlib>
 
 namespace lab {
 
 namespace {
 /**
- * @brief Points to the max value BigNum array's cell can hold,
- *        same as basis in linear representation
+ * @brief Double-width cell used for intermediate products and carries
  */
-constexpr int NUM_BASE = 1000000000;
+using DoubleLimb = unsigned __int128;
 
 /**
- * @brief Points to number of digits in (NUM_BASE-1)
+ * @brief Number of bits in a single limb
  */
-constexpr char SECTION_DIGITS = 9;
+constexpr int LIMB_BITS = 64;
 
+/**
+ * @brief Biggest power of ten that fits a single limb,
+ *        used as basis for decimal conversions
+ */
+constexpr Limb DECIMAL_BASE = 10000000000000000000ull;
+
+/**
+ * @brief Points to number of digits in DECIMAL_BASE sections
+ */
+constexpr char SECTION_DIGITS = 19;
+
+using Digits = LimbVector<BigNum::INLINE_LIMBS>;
+
+/**
+ * @brief Temporary limbs, must be allocated from LimbResourceScope::current()
+ */
+using LimbBuffer = std::pmr::vector<Limb>;
+
+inline void removeLeadingZeros(Digits& num) {
+    while (!num.empty() && num.back() == 0) {
+        num.pop_back();
+    }
 }
 
-BigNum::BigNum(std::string_view num_str) {
-    for (int i = num_str.size() - 1; i >= 0; i -= SECTION_DIGITS) {
-        std::string curr_section;
-        if (i - SECTION_DIGITS + 1 < 0) {
-            curr_section = num_str.substr(0, SECTION_DIGITS + (i - SECTION_DIGITS + 1));
+/**
+ * @brief Adds src to dst in place, dst grows only if carry goes out of its limbs
+ */
+void addLimbs(Digits& dst, BigNumView src) {
+    if (dst.size() < src.size()) {
+        dst.resize(src.size());
+    }
+    Limb* rest = dst.data() + src.size();
+    Limb carry = mpn::add_n(dst.data(), dst.data(), src.data(), src.size());
+    carry = mpn::add_1(rest, rest, dst.size() - src.size(), carry);
+    if (carry != 0) {
+        dst.push_back(carry);
+    }
+}
+
+/**
+ * @brief Subtracts src from dst in place
+ * @note dst must be bigger than src
+ */
+void subtractLimbs(Digits& dst, BigNumView src) {
+    Limb* rest = dst.data() + src.size();
+    const Limb borrow = mpn::sub_n(dst.data(), dst.data(), src.data(), src.size());
+    mpn::sub_1(rest, rest, dst.size() - src.size(), borrow);
+    removeLeadingZeros(dst);
+}
+
+/**
+ * @brief Replaces dst with minuend - dst
+ * @note minuend must be bigger than dst
+ */
+void subtractLimbsReversed(Digits& dst, BigNumView minuend) {
+    dst.resize(minuend.size());
+    mpn::sub_n(dst.data(), minuend.data(), dst.data(), minuend.size());
+    removeLeadingZeros(dst);
+}
+
+/**
+ * @brief Multiplies num by single limb in place
+ */
+void multiplyLimbs(Digits& num, Limb factor) {
+    const Limb carry = mpn::mul_1(num.data(), num.data(), num.size(), factor);
+    num.push_back(carry);
+    removeLeadingZeros(num);
+}
+
+/**
+ * @brief Knuth's Algorithm D on divisor normalized so that its top bit is set. Every quotient limb
+ *        is estimated from the top two limbs of the rest by the top limb of divisor, corrected by
+ *        the next limb of divisor, which leaves it at most one too big, and the rare excess
+ *        is added back after multiply-subtract
+ * @param inverse mpn::invert_limb of the top limb of divisor, which replaces division of limbs
+ * @param quotient place for num_size - size limbs
+ * @return The top limb of quotient, 0 or 1, which is not written to quotient.
+ *         The remainder replaces the low size limbs of num
+ */
+Limb divideSchoolbook(Limb* num, std::size_t num_size, const Limb* divisor, std::size_t size, Limb inverse,
+                      Limb* quotient) {
+    Limb* top_part = num + num_size - size;
+    const Limb high = mpn::cmp(top_part, divisor, size) >= 0;
+    if (high != 0) {
+        mpn::sub_n(top_part, top_part, divisor, size);
+    }
+
+    const Limb top = divisor[size - 1];
+    const Limb next = size > 1 ? divisor[size - 2] : 0;
+    for (std::size_t step = num_size - size; step-- > 0;) {
+        Limb* window = num + step;
+        // the top limb of the rest is at most the top limb of divisor, when they are equal
+        // the estimate is capped by the largest limb
+        Limb digit;
+        Limb estimate_rest;
+        bool rest_overflow = false;
+        if (__builtin_expect(window[size] == top, 0)) {
+            digit = ~static_cast<Limb>(0);
+            estimate_rest = window[size - 1] + top;
+            rest_overflow = estimate_rest < top;
         } else {
-            curr_section = num_str.substr(i - SECTION_DIGITS + 1, SECTION_DIGITS);
+            digit = mpn::divrem_2by1(window[size], window[size - 1], top, inverse, estimate_rest);
+        }
+        const Limb third = size > 1 ? window[size - 2] : 0;
+        while (!rest_overflow
+               && static_cast<DoubleLimb>(digit) * next
+                      > ((static_cast<DoubleLimb>(estimate_rest) << LIMB_BITS) | third)) {
+            --digit;
+            estimate_rest += top;
+            rest_overflow = estimate_rest < top;
+        }
+
+        const Limb borrow = mpn::submul_1(window, divisor, size, digit);
+        if (window[size] < borrow) {
+            --digit;
+            window[size] += mpn::add_n(window, window, divisor, size);
         }
-        _digits.push_back(std::stoi(curr_section));
+        window[size] -= borrow;
+        quotient[step] = digit;
     }
-    while (!_digits.empty() && _digits.back() == 0) {
-        _digits.pop_back();
+    return high;
+}
+
+/**
+ * @brief Limbs of divisor which division takes, what Divisor holds. One-off divisions prepare
+ *        them on the stack, so that divisor is not copied into Divisor first
+ */
+struct DivisorLimbs {
+    BigNumView value;
+    const Limb* normalized;
+    unsigned shift;
+    Limb inverse;
+};
+
+/**
+ * @brief Writes divisor shifted so that its top bit is set to normalized
+ * @param normalized place for divisor.size() limbs
+ * @note Divisor must not be zero
+ */
+DivisorLimbs prepareDivisor(BigNumView divisor, Limb* normalized) {
+    const auto shift = static_cast<unsigned>(__builtin_clzll(divisor[divisor.size() - 1]));
+    if (shift != 0) {
+        mpn::lshift(normalized, divisor.data(), divisor.size(), shift);
+    } else {
+        std::copy(divisor.begin(), divisor.end(), normalized);
     }
+    return DivisorLimbs{divisor, normalized, shift, mpn::invert_limb(normalized[divisor.size() - 1])};
 }
 
-std::string to_string(const BigNum &num)
-{
-    std::string result;
-    int leading_zeros = 0;
+/**
+ * @brief Writes quotient and remainder of num by divisor, the method depends on their sizes
+ * @param quotient place for num.size() - divisor.size() + 1 limbs
+ * @param remainder place for divisor.size() limbs
+ * @note Num must not be shorter than divisor, which must not be zero
+ */
+void divideLimbs(BigNumView num, const DivisorLimbs& divisor, Limb* quotient, Limb* remainder);
 
-    for (int curr_pos = 0; curr_pos < num._digits.size(); ++curr_pos) {
-        std::string temp = std::to_string(num._digits[curr_pos]);
-        std::string offset;
-        leading_zeros = 0;
-        while (temp.size() + offset.size() != SECTION_DIGITS) {
-            offset += '0';
-            ++leading_zeros;
+/**
+ * @brief Resizes quotient and remainder and divides num by divisor to them
+ * @note Num must not be shorter than divisor
+ */
+void divideTo(BigNumView num, const DivisorLimbs& divisor,
+              LimbVector<BigNum::INLINE_LIMBS>& quotient, LimbVector<BigNum::INLINE_LIMBS>& remainder) {
+    quotient.resize(num.size() - divisor.value.size() + 1);
+    remainder.resize(divisor.value.size());
+    divideLimbs(num, divisor, quotient.data(), remainder.data());
+    removeLeadingZeros(quotient);
+    removeLeadingZeros(remainder);
+}
+
+}
+
+BigNum::BigNum(BigNumView view)
+    : _digits(view.begin(), view.end()) {
+}
+
+BigNum::BigNum(std::string_view num_str) {
+    const std::size_t head = num_str.size() % SECTION_DIGITS;
+    for (std::size_t pos = 0; pos < num_str.size();) {
+        const std::size_t length = (pos == 0 && head != 0) ? head : SECTION_DIGITS;
+        Limb section = 0;
+        Limb scale = 1;
+        for (std::size_t i = pos; i < pos + length; ++i) {
+            if (num_str[i] < '0' || num_str[i] > '9')
+                throw std::invalid_argument("Number must consist of decimal digits.");
+            section = section * 10 + (num_str[i] - '0');
+            scale *= 10;
+        }
+        pos += length;
+
+        Limb* digits = _digits.data();
+        // the number times scale plus section fits one more limb, so the carries never overflow it
+        Limb carry = mpn::mul_1(digits, digits, _digits.size(), scale);
+        carry += mpn::add_1(digits, digits, _digits.size(), section);
+        if (carry != 0) {
+            _digits.push_back(carry);
         }
-        result = offset + temp + result;
+    }
+}
+
+std::string to_string(BigNumView num)
+{
+    if (num.empty()) {
+        return "0";
+    }
+
+    Digits rest(num.begin(), num.end());
+    LimbBuffer sections(LimbResourceScope::current());
+    while (!rest.empty()) {
+        sections.push_back(mpn::divrem_1(rest.data(), rest.data(), rest.size(), DECIMAL_BASE));
+        removeLeadingZeros(rest);
     }
 
-    result.erase(0, leading_zeros);
+    std::string result = std::to_string(sections.back());
+    for (auto it = sections.rbegin() + 1; it != sections.rend(); ++it) {
+        const std::string temp = std::to_string(*it);
+        result.append(SECTION_DIGITS - temp.size(), '0');
+        result += temp;
+    }
     return result;
 }
 
@@ -59,87 +248,112 @@ const BigNum& BigNum::inf() {
     return _inf;
 }
 
-bool operator<(const BigNum &left, const BigNum &right) {
-    if (left._digits.size() < right._digits.size()) return true;
-    if (left._digits.size() > right._digits.size()) return false;
-    for (int curr_pos = left._digits.size() - 1; curr_pos >= 0; --curr_pos) {
-        if (left._digits[curr_pos] < right._digits[curr_pos]) return true;
-        if (left._digits[curr_pos] > right._digits[curr_pos]) return false;
+bool operator<(BigNumView left, BigNumView right) {
+    if (left.size() < right.size()) return true;
+    if (left.size() > right.size()) return false;
+    for (int curr_pos = left.size() - 1; curr_pos >= 0; --curr_pos) {
+        if (left[curr_pos] < right[curr_pos]) return true;
+        if (left[curr_pos] > right[curr_pos]) return false;
     }
     return false;
 }
 
-bool operator>(const BigNum &left, const BigNum &right) {
+bool operator>(BigNumView left, BigNumView right) {
     return (right < left);
 }
 
-bool operator<=(const BigNum &left, const BigNum &right) {
+bool operator<=(BigNumView left, BigNumView right) {
     return !(right < left);
 }
 
-bool operator>=(const BigNum &left, const BigNum &right) {
+bool operator>=(BigNumView left, BigNumView right) {
     return !(left < right);
 }
 
-bool operator==(const BigNum &left, const BigNum &right) {
-    return ((!(right < left)) && (!(left < right)));
+bool operator==(BigNumView left, BigNumView right) {
+    return std::equal(left.begin(), left.end(), right.begin(), right.end());
 }
 
-bool operator!=(const BigNum &left, const BigNum &right) {
+bool operator!=(BigNumView left, BigNumView right) {
     return !(left == right);
 }
 
-BigNum operator+(const BigNum &left, const BigNum &right) {
+BigNum operator+(BigNumView left, BigNumView right) {
+    const bool left_longer = left.size() >= right.size();
+    const auto& longer = left_longer ? left : right;
+    const auto& shorter = left_longer ? right : left;
+
     BigNum result;
-    if (right._digits.size() > left._digits.size()) {
-        result = right;
-        int addition = 0;
-        for (int curr_pos = 0; curr_pos < left._digits.size(); ++curr_pos) {
-            result._digits[curr_pos] += left._digits[curr_pos] + addition;
-            addition = result._digits[curr_pos] / NUM_BASE;
-            result._digits[curr_pos] = result._digits[curr_pos] % NUM_BASE;
-        }
-    } else {
-        result = left;
-        int addition = 0;
-        for (int curr_pos = 0; curr_pos < right._digits.size(); ++curr_pos) {
-            long long temp = static_cast<long long>(result._digits[curr_pos])
-                    + static_cast<long long>(right._digits[curr_pos]) + addition;
-            result._digits[curr_pos] = temp % NUM_BASE;
-            addition = temp / NUM_BASE;
-            result._digits[curr_pos] = result._digits[curr_pos] % NUM_BASE;
-        }
-    }
+    result._digits.reserve(longer.size() + 1);
+    result._digits.assign(longer.begin(), longer.end());
+    addLimbs(result._digits, shorter);
     return result;
 }
 
-BigNum operator-(const BigNum &left, const BigNum &right) {
-    BigNum result = left;
-    for (int curr_pos = 0; curr_pos < right._digits.size(); ++curr_pos) {
-        if (result._digits[curr_pos] < right._digits[curr_pos]) {
-            result._digits[curr_pos] = result._digits[curr_pos] - right._digits[curr_pos] + NUM_BASE;
-            result._digits[curr_pos + 1] -= 1;
-        } else {
-            result._digits[curr_pos] = result._digits[curr_pos] - right._digits[curr_pos];
-        }
-    }
-    if (left._digits.size() > right._digits.size()) {
-        if (result._digits[right._digits.size()] < 0) {
-            result._digits[right._digits.size()] += NUM_BASE;
-            result._digits[right._digits.size() + 1] -= 1;
-        }
-    }
+BigNum operator+(BigNum &&left, BigNumView right) {
+    addLimbs(left._digits, right);
+    return std::move(left);
+}
+
+BigNum operator+(BigNumView left, BigNum &&right) {
+    addLimbs(right._digits, left);
+    return std::move(right);
+}
+
+BigNum operator+(BigNum &&left, BigNum &&right) {
+    return std::move(left) + right;
+}
+
+BigNum& BigNum::operator+=(BigNumView other) {
+    addLimbs(_digits, other);
+    return *this;
+}
+
+BigNum& BigNum::operator-=(BigNumView other) {
+    subtractLimbs(_digits, other);
+    return *this;
+}
+
+BigNum& BigNum::operator*=(BigNumView other) {
+    *this = *this * other;
+    return *this;
+}
+
+BigNum& BigNum::operator*=(int other) {
+    multiplyLimbs(_digits, static_cast<Limb>(other));
+    return *this;
+}
+
+BigNum& BigNum::operator%=(BigNumView mod) {
+    modify(*this, mod);
+    return *this;
+}
+
+BigNum operator-(BigNumView left, BigNumView right) {
+    BigNum result(left);
+    subtractLimbs(result._digits, right);
     return result;
 }
 
-std::vector<char> toOneDigit(const BigNum &num) {
+BigNum operator-(BigNum &&left, BigNumView right) {
+    subtractLimbs(left._digits, right);
+    return std::move(left);
+}
+
+BigNum operator-(BigNumView left, BigNum &&right) {
+    subtractLimbsReversed(right._digits, left);
+    return std::move(right);
+}
+
+BigNum operator-(BigNum &&left, BigNum &&right) {
+    return std::move(left) - right;
+}
+
+std::vector<char> toOneDigit(BigNumView num) {
+    const std::string str_num = to_string(num);
     std::vector<char> fnum;
-    for (int curr_pos = 0; curr_pos < num._digits.size(); ++curr_pos) {
-        int counter = num._digits[curr_pos];
-        for (int i = 0; i < SECTION_DIGITS; ++i) {
-            fnum.push_back(counter % 10);
-            counter = counter / 10;
-        }
+    for (auto it = str_num.rbegin(); it != str_num.rend(); ++it) {
+        fnum.push_back(*it - '0');
     }
     while (!fnum.empty() && fnum.back() == 0) {
         fnum.pop_back();
@@ -162,377 +376,1426 @@ BigNum toBigNum(std::vector<char> &num_digits) {
 }
 
 BigNum operator*(const BigNum &left, int right) {
-    BigNum result = left;
-    unsigned long long addition = 0;
-    for (int curr_pos = 0; curr_pos < result._digits.size(); ++curr_pos) {
-        unsigned long long temp = static_cast<long long>(result._digits[curr_pos]) * right + addition;
-        result._digits[curr_pos] = temp % NUM_BASE;
-        addition = temp / NUM_BASE;
-    }
-    if (addition >= NUM_BASE) {
-        result._digits.push_back(addition % NUM_BASE);
-        result._digits.push_back(addition / NUM_BASE);
-    } else {
-        result._digits.push_back(addition);
-    }
-    while (!result._digits.empty() && result._digits.back() == 0)
-        result._digits.pop_back();
+    BigNum result;
+    result._digits.reserve(left._digits.size() + 1);
+    result._digits.assign(left._digits.begin(), left._digits.end());
+    multiplyLimbs(result._digits, static_cast<Limb>(right));
     return result;
 }
 
-/**
- * @brief Compares vector of digits with operator <
- * @param step points to the number of digits from beginning of left var to compare
- */
-bool isLowerDigits(const std::vector<char> &left, const std::vector<char> &right, int step) {
-    if ((step > right.size()) && (step <= left.size())) return false;
-    if ((step < right.size()) || (left.size() < right.size())) return true;
-    if (step > left.size()) return true;
-    for (int i = right.size() - 1; i >= 0; --i) {
-        if (left[left.size() + i - step] < right[i]) return true;
-        if (left[left.size() + i - step] > right[i]) return false;
+BigNum operator*(BigNum &&left, int right) {
+    multiplyLimbs(left._digits, static_cast<Limb>(right));
+    return std::move(left);
+}
+
+Divisor::Divisor(BigNumView divisor)
+    : _value(divisor) {
+    if (divisor.empty()) {
+        throw std::invalid_argument("Division by zero.");
     }
-    return false;
+    _normalized._digits.resize(divisor.size());
+    const auto limbs = prepareDivisor(divisor, _normalized._digits.data());
+    _shift = limbs.shift;
+    _inverse = limbs.inverse;
 }
 
-bool isLowerDigits(const std::vector<char> &left, const std::vector<char> &right, int step);
+std::pair<BigNum, BigNum> extract(BigNumView left, BigNumView right) {
+    if (right.empty()) {
+        throw std::invalid_argument("Division by zero.");
+    }
+    if (right.size() == 1) {
+        auto [quotient, remainder] = divmod_1(left, right[0]);
+        return std::pair(std::move(quotient), BigNum(BigNumView(&remainder, 1)));
+    }
+    if (left < right) {
+        return std::pair(BigNum(), BigNum(left));
+    }
 
-auto addDigits (const std::vector <char> &lhs, const std::vector <char> &rhs) {
+    LimbVector<BigNum::INLINE_LIMBS> normalized(right.size());
+    BigNum quotient;
+    BigNum remainder;
+    divideTo(left, prepareDivisor(right, normalized.data()), quotient._digits, remainder._digits);
+    return std::pair(std::move(quotient), std::move(remainder));
+}
 
-    constexpr auto BASE = 10;
-    std::vector <char> result;
+std::pair<BigNum, BigNum> extract(BigNumView num, const Divisor& divisor) {
+    if (num < divisor.value()) {
+        return std::pair(BigNum(), BigNum(num));
+    }
 
+    BigNum quotient;
+    BigNum remainder;
+    const DivisorLimbs limbs{divisor.value(), divisor.normalized().data(), divisor.shift(), divisor.inverse()};
+    divideTo(num, limbs, quotient._digits, remainder._digits);
+    return std::pair(std::move(quotient), std::move(remainder));
+}
 
-    if (isLowerDigits(lhs, rhs, 0)) {
-        result = rhs;
-        int addition{};
-        for (std::size_t i = 0; i < rhs.size(); ++i) {
-            result[i] += (i >= lhs.size()) ? addition : lhs[i] + addition;
-            addition = result[i] / BASE;
-            result[i] %= BASE;
-        }
-    } else {
-        result = lhs;
-        int addition{};
-        for (std::size_t i = 0; i < rhs.size(); ++i) {
-            result[i] += (i >= rhs.size()) ? addition : rhs[i] + addition;
-            addition = result[i] / BASE;
-            result[i] %= BASE;
-        }
+std::pair<BigNum, Limb> divmod_1(BigNumView num, Limb divisor) {
+    if (divisor == 0) {
+        throw std::invalid_argument("Division by zero.");
     }
-    return result;
+    BigNum quotient;
+    quotient._digits.resize(num.size());
+    const Limb remainder = mpn::divrem_1(quotient._digits.data(), num.data(), num.size(), divisor);
+    removeLeadingZeros(quotient._digits);
+    return std::pair(std::move(quotient), remainder);
 }
 
-/**
- * @brief Multiplies vector of digits and int
- */
-std::vector<char> multiplyDigits(std::vector<char> &num1, int num2) {
-    std::vector<char> result = num1;
-    int addition = 0;
-    for (int curr_pos = 0; curr_pos < result.size(); ++curr_pos) {
-        long long temp = result[curr_pos] * num2 + addition;
-        result[curr_pos] = temp % 10;
-        addition = temp / 10;
+void modify(BigNum &num, BigNumView mod) {
+    if (num >= mod) {
+        num = num % mod;
     }
-    if (addition != 0) {
-        result.push_back(addition);
+}
+
+void modify(BigNum &num, const Divisor& mod) {
+    if (num >= mod.value()) {
+        num = num % mod;
     }
-    return result;
 }
 
-/**
- * @brief Returns power of basis to make two numbers almost equal
- * @param fnum number to reach
- * @param snum number to multiply
- * @return Maximum power of basis to reach bottom border of fnum
- */
-int getMaxPow(std::vector<char> &fnum, std::vector<char> &snum)
-{
-    if (snum.size() > fnum.size()) {
-        return -1;
+void modifyAdd(BigNum &num, BigNumView other, BigNumView mod) {
+    if (other >= mod) {
+        modifyAdd(num, other % mod, mod);
+        return;
     }
-    int current_pow = fnum.size() - snum.size();
-    for (int i = snum.size() - 1; i >= 0; --i) {
-        if (snum[i] > fnum[i + current_pow]) {
-            return current_pow - 1;
-        }
-        if (snum[i] < fnum[i + current_pow]) {
-            return current_pow;
-        }
+    modify(num, mod);
+    num += other;
+    if (num >= mod) {
+        num -= mod;
     }
-    return current_pow;
 }
 
-/// TODO fix +=10 after changing basis
-/**
- * @brief Subtracts two numbers, where second one is multiplied on basis with given power.
- *        Result stores in first parameter
- * @param curr_pow power of basis
- */
-void subtractPow(std::vector<char> &fnum, std::vector<char> &snum, int curr_pow)
-{
-    for (int i = 0; i < snum.size(); ++i) {
-        if (fnum[i + curr_pow] < snum[i]) {
-            fnum[i + curr_pow] += 10;
-            fnum[i + curr_pow + 1] -= 1;
-        }
-        fnum[i + curr_pow] -= snum[i];
+void modifySubtract(BigNum &num, BigNumView other, BigNumView mod) {
+    if (other >= mod) {
+        modifySubtract(num, other % mod, mod);
+        return;
+    }
+    modify(num, mod);
+    if (num < other) {
+        num += mod;
     }
+    num -= other;
 }
 
-/**
- * @brief Compares with operator<= two numbers, where second one is multiplied on basis with given power
- * @param curr_pow power of basis
- */
-bool lessNumPow(std::vector<char> &fnum, std::vector<char> &snum, int curr_pow)
-{
-    if (curr_pow + snum.size() < fnum.size()) {
-        return true;
+void modifyMultiply(BigNum &num, BigNumView other, BigNumView mod) {
+    // up to three reductions by the same modulus share one prepared divisor
+    modifyMultiply(num, other, Divisor(mod));
+}
+
+void modifyAdd(BigNum &num, BigNumView other, const Divisor& mod) {
+    if (other >= mod.value()) {
+        modifyAdd(num, other % mod, mod);
+        return;
     }
-    for (int i = snum.size() - 1; i >= 0; --i) {
-        if (fnum[i + curr_pow] < snum[i]) {
-            return false;
-        }
-        if (fnum[i + curr_pow] > snum[i]) {
-            return true;
-        }
+    modify(num, mod);
+    num += other;
+    if (num >= mod.value()) {
+        num -= mod.value();
     }
-    return true;
-}
-
-std::pair<BigNum, BigNum> extract(const BigNum &left, const BigNum &right) {
-    if (left < right)
-        return std::pair<BigNum, BigNum>(BigNum("0"), left);
-    std::vector<char> fnum = toOneDigit(left);
-    std::vector<char> snum = toOneDigit(right);
-    std::vector<char> current = snum;
-    std::vector<char> result;
-    int curr_pow = getMaxPow(fnum, snum);
-    int hight_rank = 1;
-    while (true) {
-        while (lessNumPow(fnum, current, curr_pow)) {
-            ++hight_rank;
-            current = multiplyDigits(snum, hight_rank);
-        }
-        current = multiplyDigits(snum, hight_rank - 1);
-        subtractPow(fnum, current, curr_pow);
-        result.push_back(hight_rank-1);
-        int to_delete = current.size();
-        while (!fnum.empty() && (fnum.back() == 0) && (to_delete > 0)) {
-            fnum.pop_back();
-            --to_delete;
-        }
-        while (!fnum.empty() && (fnum.back() == 0)) {
-            fnum.pop_back();
-            --curr_pow;
-            result.push_back(0);
-        }
-        if ((fnum.size() <= curr_pow) && (curr_pow <= snum.size()) && !lessNumPow(fnum, snum, 0)) {
-            for (int i = 0; i < fnum.size(); i++) {
-                result.push_back(0);
-            }
-        }
-        int new_pow = getMaxPow(fnum, snum);
-        if (new_pow == -1) {
-            break;
-        }
-        while (curr_pow != new_pow + 1) {
-            --curr_pow;
-            result.push_back(0);
-        }
-        --curr_pow;
-        hight_rank = 1;
-        current = snum;
+}
+
+void modifySubtract(BigNum &num, BigNumView other, const Divisor& mod) {
+    if (other >= mod.value()) {
+        modifySubtract(num, other % mod, mod);
+        return;
+    }
+    modify(num, mod);
+    if (num < other) {
+        num += mod.value();
+    }
+    num -= other;
+}
+
+void modifyMultiply(BigNum &num, BigNumView other, const Divisor& mod) {
+    if (other >= mod.value()) {
+        modifyMultiply(num, other % mod, mod);
+        return;
     }
-    std::reverse(result.begin(), result.end());
-    return std::pair<BigNum, BigNum>(toBigNum(result), toBigNum(fnum));
+    modify(num, mod);
+    num *= other;
+    modify(num, mod);
 }
 
-void modify(BigNum &num, const BigNum &mod) {
-    num = extract(num, mod).second;
+BigNum add(BigNumView left, BigNumView right, BigNumView mod) {
+    BigNum result(left);
+    modifyAdd(result, right, mod);
+    return result;
 }
 
-BigNum add(const BigNum &left, const BigNum &right, const BigNum &mod) {
-    auto t_num2 = right % mod;
-    auto t_num1 = left % mod;
-    BigNum result = t_num1 + t_num2;
-    modify(result, mod);
+BigNum subtract(BigNumView left, BigNumView right, BigNumView mod) {
+    BigNum result(left);
+    modifySubtract(result, right, mod);
     return result;
 }
 
-BigNum subtract(const BigNum &left, const BigNum &right, const BigNum &mod) {
-    auto t_num2 = right % mod;
-    auto t_num1 = left % mod;
-    BigNum result;
-    if (t_num1 >= t_num2) {
-        result = t_num1 - t_num2;
-    } else {
-        result = mod - t_num2 + t_num1;
+BigNum operator%(BigNumView left, BigNumView right) {
+    if (right.size() == 1) {
+        const Limb remainder = mpn::mod_1(left.data(), left.size(), right[0]);
+        return BigNum(BigNumView(&remainder, 1));
     }
-    return result;
+    return extract(left, right).second;
 }
 
-BigNum operator%(const BigNum &left, const BigNum &right) {
-    BigNum result = extract(left, right).second;
-    return result;
+BigNum operator%(BigNumView num, const Divisor& divisor) {
+    if (divisor.size() == 1) {
+        const Limb remainder = mpn::mod_1_preinv(num.data(), num.size(), divisor.normalized()[0],
+                                                 divisor.shift(), divisor.inverse());
+        return BigNum(BigNumView(&remainder, 1));
+    }
+    return extract(num, divisor).second;
 }
 
 namespace {
-    /*
-    *  @brief Class for read-only range of elements of some std::vector.
-    */
-    template <typename T>
-    class ArrayView  {
-    public:
-        template <typename Iter,
-                  typename = std::enable_if <std::is_same_v<typename std::iterator_traits<Iter>::iterator_category,
-                                                            std::random_access_iterator_tag>
-                                          || std::is_same_v <Iter, T*>>>
-        explicit ArrayView(Iter begin,
-                           Iter end)
-                         : m_begin(&(*begin)),
-                           m_size(end - begin) {
+    /**
+     * @brief Adds src to dst shifted by offset limbs, carry is propagated through the rest of dst
+     */
+    inline void addShifted(Limb* dst, std::size_t dst_size,
+                           const Limb* src, std::size_t src_size, std::size_t offset) {
+        Limb* rest = dst + offset + src_size;
+        const Limb carry = mpn::add_n(dst + offset, dst + offset, src, src_size);
+        mpn::add_1(rest, rest, dst_size - offset - src_size, carry);
+    }
+
+    /**
+     * @brief Subtracts src from dst in place
+     * @note dst must be bigger than src
+     */
+    inline void subtractInPlace(Limb* dst, std::size_t dst_size, const Limb* src, std::size_t src_size) {
+        const Limb borrow = mpn::sub_n(dst, dst, src, src_size);
+        mpn::sub_1(dst + src_size, dst + src_size, dst_size - src_size, borrow);
+    }
+
+    /**
+     * @brief Writes square of num to result, which must hold size * 2 limbs.
+     *        Columns are summed like in portable basecase multiplication, but every cross
+     *        product is computed once and doubled along with the rest of the column
+     * @note Result must not overlap num
+     */
+    void basecaseSquare(const Limb* num, std::size_t size, Limb* result) {
+        if (size == 0) {
+            return;
+        }
+        DoubleLimb carry = 0;
+        for (std::size_t column = 0; column + 1 < size * 2; ++column) {
+            const std::size_t first = column < size ? 0 : column - size + 1;
+            mpn::ColumnSum cross;
+            // products below the middle of the column, each of them stands for two
+            cross.addProducts(num, num, column, first, (column + 1) / 2);
+            cross.doubled();
+            if (column % 2 == 0) {
+                cross.add(static_cast<DoubleLimb>(num[column / 2]) * num[column / 2]);
+            }
+            cross.add(carry);
+            result[column] = cross.next();
+            carry = cross.low;
         }
+        result[size * 2 - 1] = static_cast<Limb>(carry);
+    }
 
-        const T* begin() const {
-            return m_begin;
+    /**
+     * @return Number from environment variable or fallback if it is not set or is not a number
+     */
+    std::size_t thresholdFromEnvironment(const char* name, std::size_t fallback) {
+        const char* value = std::getenv(name);
+        if (value == nullptr || *value == '\0') {
+            return fallback;
         }
+        char* end = nullptr;
+        const auto parsed = std::strtoull(value, &end, 10);
+        return *end == '\0' ? static_cast<std::size_t>(parsed) : fallback;
+    }
+
+    /**
+     * @brief Keeps thresholds high enough for every method to split its operands
+     */
+    Thresholds sanitized(Thresholds thresholds) {
+        thresholds.karatsuba = std::max<std::size_t>(thresholds.karatsuba, 4);
+        thresholds.toom3 = std::max<std::size_t>(thresholds.toom3, 16);
+        thresholds.ntt = std::max<std::size_t>(thresholds.ntt, 64);
+        thresholds.division = std::max<std::size_t>(thresholds.division, 2);
+        thresholds.newton = std::max<std::size_t>(thresholds.newton, 8);
+        return thresholds;
+    }
 
-        const T* end() const {
-            return m_begin + m_size;
+    Thresholds& activeThresholds() {
+        static Thresholds thresholds = sanitized({
+            thresholdFromEnvironment("LAB_MIN_FOR_KARATSUBA", MIN_FOR_KARATSUBA),
+            thresholdFromEnvironment("LAB_MIN_FOR_TOOM3", MIN_FOR_TOOM3),
+            thresholdFromEnvironment("LAB_MIN_FOR_NTT", MIN_FOR_NTT),
+            thresholdFromEnvironment("LAB_MIN_FOR_PARALLEL", MIN_FOR_PARALLEL),
+            thresholdFromEnvironment("LAB_MIN_FOR_DIVISION", MIN_FOR_DIVISION),
+            thresholdFromEnvironment("LAB_MIN_FOR_NEWTON", MIN_FOR_NEWTON)
+        });
+        return thresholds;
+    }
+
+    /**
+     * @return Whether products of a single level of recursion on operands of given size
+     *         run in parallel, each of them needs its own scratch then
+     */
+    inline bool isParallel(std::size_t length) {
+        return length >= activeThresholds().parallel;
+    }
+
+    /**
+     * @return Number of scratches for given number of products of a single level of recursion
+     */
+    inline std::size_t scratchCopies(std::size_t length, std::size_t products) {
+        return isParallel(length) ? products : 1;
+    }
+
+    /**
+     * @brief Calls every product with scratch for it. Long operands are multiplied in parallel
+     *        on shared thread pool and products get consecutive parts of scratch of
+     *        product_scratch limbs, short ones are multiplied one by one in the same scratch
+     */
+    template <typename... Products>
+    void runProducts(std::size_t length, Limb* scratch, std::size_t product_scratch, Products... products) {
+        if (!isParallel(length)) {
+            (products(scratch), ...);
+            return;
         }
+        std::vector<ThreadPool::Task> tasks;
+        std::size_t index = 0;
+        (tasks.emplace_back([products, own = scratch + product_scratch * index++] { products(own); }), ...);
+        ThreadPool::shared().forkJoin(std::move(tasks));
+    }
+
+    std::size_t multiplicationScratchSize(std::size_t length);
+
+    void multiplyBalanced(BigNumView lhs, BigNumView rhs, Limb* result, Limb* scratch);
+
+    void squareBalanced(BigNumView num, Limb* result, Limb* scratch);
 
-        const auto size() const {
-            return m_size;
+    /**
+     * @return Number of scratch limbs karatsuba needs for operands of given size
+     */
+    std::size_t karatsubaScratchSize(std::size_t length) {
+        const auto high = length - length / 2;
+        // both sums of halves and their product with a carry limb
+        return 4 * high + 1 + scratchCopies(length, 3) * multiplicationScratchSize(high);
+    }
+
+    /**
+     * @brief Scratch of a thread up to this many limbs, 8 MiB, is kept between calls
+     */
+    constexpr std::size_t RETAINED_SCRATCH_LIMBS = std::size_t(1) << 20;
+
+    /**
+     * @brief Thread-local scratch memory of at least given size for the time of a call.
+     *        It grows geometrically up to RETAINED_SCRATCH_LIMBS and is kept between calls,
+     *        so multiplication does not allocate temporaries once it is warmed up. Longer one
+     *        is released when the outermost workspace of the thread goes out of scope, so that
+     *        a thread which multiplied huge numbers once does not hold their scratch
+     * @note Every workspace of a thread shares the same memory, an inner one may move it,
+     *       so an outer one must not be used after it
+     */
+    class ScratchWorkspace {
+    public:
+        explicit ScratchWorkspace(std::size_t size) {
+            auto& limbs = memory();
+            if (limbs.size() < size) {
+                limbs.resize(std::max(size, std::min(limbs.size() * 2, RETAINED_SCRATCH_LIMBS)));
+            }
+            ++depth();
+        }
+
+        ScratchWorkspace(const ScratchWorkspace&) = delete;
+        ScratchWorkspace& operator=(const ScratchWorkspace&) = delete;
+
+        ~ScratchWorkspace() {
+            if (--depth() == 0 && memory().size() > RETAINED_SCRATCH_LIMBS) {
+                std::vector<Limb>().swap(memory());
+            }
         }
 
-        const auto& operator[](std::size_t n) const {
-            if (n >= m_size)
-                throw std::out_of_range("Out of view range.");
-            return *(m_begin + n);
+        Limb* data() const {
+            return memory().data();
         }
 
     private:
-        const T* m_begin;
-        std::size_t m_size;
+        static std::vector<Limb>& memory() {
+            thread_local std::vector<Limb> limbs;
+            return limbs;
+        }
+
+        static std::size_t& depth() {
+            thread_local std::size_t count = 0;
+            return count;
+        }
     };
 
-    template <typename Iter>
-    ArrayView (Iter begin, Iter end) -> ArrayView<typename std::iterator_traits<Iter>::value_type>;
+    /*
+     * @brief Karatsuba's method implements fast multiplication of numbers [AB] and [CD] like
+     *        like (A * 10 + B) * (C * 10 + D) = AC * 100 + BD + ((A + B) * (C + D) - AC - BD) * 10
+     * @param result place for lhs.size() * 2 limbs of product
+     * @param scratch place for karatsubaScratchSize(lhs.size()) limbs of temporaries
+     * @note Both operands must have the same size, the upper part gets the odd limb
+     */
+
+    void karatsuba(BigNumView lhs, BigNumView rhs, Limb* result, Limb* scratch) {
 
-    using IntVectorView = ArrayView<int64_t>;
+        const auto length = lhs.size();
+        const auto half = length / 2;
+        const auto high = length - half;
+
+        const auto lhsL = BigNumView::untrimmed(lhs.begin() + half, high);
+        const auto rhsL = BigNumView::untrimmed(rhs.begin() + half, high);
+        const auto lhsR = BigNumView::untrimmed(lhs.begin(), half);
+        const auto rhsR = BigNumView::untrimmed(rhs.begin(), half);
+
+        // c2 goes to the lower part of result and c1 to the upper one
+        Limb* c1 = result + half * 2;
+        Limb* c2 = result;
+
+        Limb* lhsLR = scratch;
+        Limb* rhsLR = scratch + high;
+        Limb* c3 = rhsLR + high;
+        Limb* rest = c3 + high * 2 + 1;
+
+        Limb lhs_carry = mpn::add_n(lhsLR, lhsL.begin(), lhsR.begin(), half);
+        lhs_carry = mpn::add_1(lhsLR + half, lhsL.begin() + half, high - half, lhs_carry);
+        Limb rhs_carry = mpn::add_n(rhsLR, rhsL.begin(), rhsR.begin(), half);
+        rhs_carry = mpn::add_1(rhsLR + half, rhsL.begin() + half, high - half, rhs_carry);
+
+        runProducts(length, rest, multiplicationScratchSize(high),
+            [&](Limb* own) { multiplyBalanced(lhsL, rhsL, c1, own); },
+            [&](Limb* own) { multiplyBalanced(lhsR, rhsR, c2, own); },
+            [&](Limb* own) {
+                multiplyBalanced(BigNumView::untrimmed(lhsLR, high), BigNumView::untrimmed(rhsLR, high), c3, own);
+            });
+
+        // sums may overflow their limbs, so their top bits are multiplied separately
+        c3[high * 2] = lhs_carry & rhs_carry;
+        if (lhs_carry != 0) {
+            addShifted(c3, high * 2 + 1, rhsLR, high, high);
+        }
+        if (rhs_carry != 0) {
+            addShifted(c3, high * 2 + 1, lhsLR, high, high);
+        }
+
+        subtractInPlace(c3, high * 2 + 1, c1, high * 2);
+        subtractInPlace(c3, high * 2 + 1, c2, half * 2);
+
+        addShifted(result, length * 2, c3, high * 2 + 1, half);
+    }
+
+    /*
+     * @brief Karatsuba's method for squares, (A * 10 + B)^2 = A^2 * 100 + B^2 + ((A + B)^2 - A^2 - B^2) * 10,
+     *        so it takes one sum and three squares
+     * @param result place for num.size() * 2 limbs of square
+     * @param scratch place for multiplicationScratchSize(num.size()) limbs of temporaries
+     */
+    void karatsubaSquare(BigNumView num, Limb* result, Limb* scratch) {
+
+        const auto length = num.size();
+        const auto half = length / 2;
+        const auto high = length - half;
+
+        const auto numL = BigNumView::untrimmed(num.begin() + half, high);
+        const auto numR = BigNumView::untrimmed(num.begin(), half);
+
+        Limb* c1 = result + half * 2;
+        Limb* c2 = result;
+
+        Limb* numLR = scratch;
+        Limb* c3 = numLR + high;
+        Limb* rest = c3 + high * 2 + 1;
+
+        Limb carry = mpn::add_n(numLR, numL.begin(), numR.begin(), half);
+        carry = mpn::add_1(numLR + half, numL.begin() + half, high - half, carry);
+
+        runProducts(length, rest, multiplicationScratchSize(high),
+            [&](Limb* own) { squareBalanced(numL, c1, own); },
+            [&](Limb* own) { squareBalanced(numR, c2, own); },
+            [&](Limb* own) { squareBalanced(BigNumView::untrimmed(numLR, high), c3, own); });
+
+        // carry of the sum adds its doubled product by the rest and its own square
+        c3[high * 2] = carry;
+        if (carry != 0) {
+            addShifted(c3, high * 2 + 1, numLR, high, high);
+            addShifted(c3, high * 2 + 1, numLR, high, high);
+        }
+
+        subtractInPlace(c3, high * 2 + 1, c1, high * 2);
+        subtractInPlace(c3, high * 2 + 1, c2, half * 2);
+
+        addShifted(result, length * 2, c3, high * 2 + 1, half);
+    }
 
     /**
-     *  @brief Returns nearest number bigger than n that is degree of two
-    */
-    inline unsigned upperLog2(unsigned n) {
-        return std::pow(2, static_cast<int>(std::log2(n)) + 1);
+     * @brief Negates number of given size in two's complement
+     */
+    inline void negate(Limb* num, std::size_t size) {
+        Limb carry = 1;
+        for (std::size_t i = 0; i < size; ++i) {
+            num[i] = ~num[i] + carry;
+            carry = carry != 0 && num[i] == 0;
+        }
     }
 
-    std::vector<int64_t> naiveMultiplication(const IntVectorView& lhs,
-                                              const IntVectorView& rhs) {
-        std::vector<int64_t> result(lhs.size() + rhs.size());
+    inline bool isNegative(const Limb* num, std::size_t size) {
+        return (num[size - 1] >> (LIMB_BITS - 1)) != 0;
+    }
 
-        for (int i = 0; i < lhs.size(); ++i) {
-            for (int j = 0; j < rhs.size(); ++j) {
-                result[i + j] += lhs[i] * rhs[j];
-            }
+    /**
+     * @brief Halves number of given size in two's complement keeping its sign
+     */
+    inline void halveSigned(Limb* num, std::size_t size) {
+        const Limb sign = num[size - 1] & (Limb(1) << (LIMB_BITS - 1));
+        mpn::rshift(num, num, size, 1);
+        num[size - 1] |= sign;
+    }
+
+    /**
+     * @brief Divides number of given size in two's complement by 3 in place,
+     *        every limb of quotient is got by multiplication by inverse of 3 modulo 2^64
+     * @note Number must be divisible by 3
+     */
+    inline void divideExactlyBy3(Limb* num, std::size_t size) {
+        constexpr Limb INVERSE_OF_3 = 0xAAAAAAAAAAAAAAABull;
+        Limb borrow = 0;
+        for (std::size_t i = 0; i < size; ++i) {
+            const Limb next_borrow = num[i] < borrow;
+            num[i] = (num[i] - borrow) * INVERSE_OF_3;
+            borrow = next_borrow + static_cast<Limb>((static_cast<DoubleLimb>(num[i]) * 3) >> LIMB_BITS);
         }
+    }
 
-        return result;
+    /**
+     * @return Number of scratch limbs toom3 needs for operands of given size
+     */
+    std::size_t toom3ScratchSize(std::size_t length) {
+        const auto part = (length + 2) / 3;
+        // three evaluations of each operand and three products of them
+        return 6 * (part + 1) + 3 * (2 * part + 2) + scratchCopies(length, 5) * multiplicationScratchSize(part + 1);
     }
 
     /**
-     * @brief Minimum size of vector of digits to do
-     *        fast multiplication instead of naive approach
+     * @brief Evaluates num = a0 + a1 * x + a2 * x^2, where x = 2^(64 * part), at points 1, -1 and -2
+     * @param at1, at_minus1, at_minus2 places for part + 1 limbs of absolute values
+     * @return Whether values at -1 and -2 are negative
      */
-    constexpr inline int MIN_FOR_KARATSUBA = 32;
+    std::pair<bool, bool> toom3Evaluate(BigNumView num, std::size_t part,
+                                        Limb* at1, Limb* at_minus1, Limb* at_minus2) {
+        const Limb* a0 = num.begin();
+        const Limb* a1 = a0 + part;
+        const Limb* a2 = a1 + part;
+        const std::size_t top_size = num.size() - part * 2;
+        const std::size_t size = part + 1;
+
+        // values are computed in two's complement and then turned into absolute ones
+        std::fill(std::copy(a0, a1, at1), at1 + size, 0);
+        addShifted(at1, size, a2, top_size, 0);
+        std::copy(at1, at1 + size, at_minus1);
+        addShifted(at1, size, a1, part, 0);
+        subtractInPlace(at_minus1, size, a1, part);
+
+        // a(-2) = (a(-1) + a2) * 2 - a0
+        std::copy(at_minus1, at_minus1 + size, at_minus2);
+        addShifted(at_minus2, size, a2, top_size, 0);
+        mpn::lshift(at_minus2, at_minus2, size, 1);
+        subtractInPlace(at_minus2, size, a0, part);
+
+        const bool minus1_negative = isNegative(at_minus1, size);
+        const bool minus2_negative = isNegative(at_minus2, size);
+        if (minus1_negative) {
+            negate(at_minus1, size);
+        }
+        if (minus2_negative) {
+            negate(at_minus2, size);
+        }
+        return std::pair(minus1_negative, minus2_negative);
+    }
 
     /*
-     * @brief Karatsuba's method implements fast multiplication of numbers [AB] and [CD] like
-     *        like (A * 10 + B) * (C * 10 + D) = AC * 100 + BD + ((A + B) * (C + D) - AC - BD) * 10
+     * @brief Toom-Cook 3-way method splits operands into three parts, multiplies
+     *        their values at points 0, 1, -1, -2 and infinity, and interpolates
+     *        the product back by Bodrato's sequence, so it takes five products of a third size
+     * @param result place for lhs.size() * 2 limbs of product
+     * @param scratch place for toom3ScratchSize(lhs.size()) limbs of temporaries
+     * @note Both operands must have the same size
      */
+    void toom3(BigNumView lhs, BigNumView rhs, Limb* result, Limb* scratch) {
+
+        const auto length = lhs.size();
+        const auto part = (length + 2) / 3;
+        const auto top_size = length - part * 2;
+        const auto value_size = part + 1;
+        const auto product_size = value_size * 2;
+
+        Limb* lhs1 = scratch;
+        Limb* lhsMinus1 = lhs1 + value_size;
+        Limb* lhsMinus2 = lhsMinus1 + value_size;
+        Limb* rhs1 = lhsMinus2 + value_size;
+        Limb* rhsMinus1 = rhs1 + value_size;
+        Limb* rhsMinus2 = rhsMinus1 + value_size;
+        Limb* w1 = rhsMinus2 + value_size;
+        Limb* wMinus1 = w1 + product_size;
+        Limb* wMinus2 = wMinus1 + product_size;
+        Limb* rest = wMinus2 + product_size;
+
+        // square evaluates its operand once, so that every product is a square too
+        const bool squaring = lhs.begin() == rhs.begin();
+        const auto [lhs_minus1_negative, lhs_minus2_negative] = toom3Evaluate(lhs, part, lhs1, lhsMinus1, lhsMinus2);
+        const auto [rhs_minus1_negative, rhs_minus2_negative] =
+                squaring ? std::pair(lhs_minus1_negative, lhs_minus2_negative)
+                         : toom3Evaluate(rhs, part, rhs1, rhsMinus1, rhsMinus2);
+        if (squaring) {
+            rhs1 = lhs1;
+            rhsMinus1 = lhsMinus1;
+            rhsMinus2 = lhsMinus2;
+        }
 
-    std::vector<int64_t> karatsuba(const IntVectorView& lhs, const IntVectorView& rhs) {
+        // values at 0 and infinity are the lowest and the highest coefficients of the product
+        Limb* w0 = result;
+        Limb* wInf = result + part * 4;
+
+        runProducts(length, rest, multiplicationScratchSize(value_size),
+            [&](Limb* own) {
+                multiplyBalanced(BigNumView::untrimmed(lhs1, value_size),
+                                 BigNumView::untrimmed(rhs1, value_size), w1, own);
+            },
+            [&](Limb* own) {
+                multiplyBalanced(BigNumView::untrimmed(lhsMinus1, value_size),
+                                 BigNumView::untrimmed(rhsMinus1, value_size), wMinus1, own);
+            },
+            [&](Limb* own) {
+                multiplyBalanced(BigNumView::untrimmed(lhsMinus2, value_size),
+                                 BigNumView::untrimmed(rhsMinus2, value_size), wMinus2, own);
+            },
+            [&](Limb* own) {
+                multiplyBalanced(BigNumView::untrimmed(lhs.begin(), part),
+                                 BigNumView::untrimmed(rhs.begin(), part), w0, own);
+            },
+            [&](Limb* own) {
+                multiplyBalanced(BigNumView::untrimmed(lhs.begin() + part * 2, top_size),
+                                 BigNumView::untrimmed(rhs.begin() + part * 2, top_size), wInf, own);
+            });
+
+        if (lhs_minus1_negative != rhs_minus1_negative) {
+            negate(wMinus1, product_size);
+        }
+        if (lhs_minus2_negative != rhs_minus2_negative) {
+            negate(wMinus2, product_size);
+        }
+        std::fill(result + part * 2, wInf, 0);
+
+        // interpolation in two's complement, every division is exact
+        // r3 = (w(-2) - w(1)) / 3
+        subtractInPlace(wMinus2, product_size, w1, product_size);
+        divideExactlyBy3(wMinus2, product_size);
+        // r1 = (w(1) - w(-1)) / 2
+        subtractInPlace(w1, product_size, wMinus1, product_size);
+        halveSigned(w1, product_size);
+        // r2 = w(-1) - w(0)
+        subtractInPlace(wMinus1, product_size, w0, part * 2);
+        // r3 = (r2 - r3) / 2 + 2 * w(inf)
+        negate(wMinus2, product_size);
+        addShifted(wMinus2, product_size, wMinus1, product_size, 0);
+        halveSigned(wMinus2, product_size);
+        addShifted(wMinus2, product_size, wInf, top_size * 2, 0);
+        addShifted(wMinus2, product_size, wInf, top_size * 2, 0);
+        // r2 = r2 + r1 - w(inf)
+        addShifted(wMinus1, product_size, w1, product_size, 0);
+        subtractInPlace(wMinus1, product_size, wInf, top_size * 2);
+        // r1 = r1 - r3
+        subtractInPlace(w1, product_size, wMinus2, product_size);
+
+        // coefficients are non-negative now and their top limbs beyond the product are zeros
+        const Limb* coefficients[] = {w1, wMinus1, wMinus2};
+        for (std::size_t i = 0; i < 3; ++i) {
+            const auto offset = part * (i + 1);
+            addShifted(result, length * 2, coefficients[i],
+                       std::min(product_size, length * 2 - offset), offset);
+        }
+    }
 
-        if (lhs.size() <= MIN_FOR_KARATSUBA)
-            return naiveMultiplication(lhs, rhs);
+    /**
+     * @return Number of scratch limbs multiplyBalanced needs for operands of given size
+     */
+    std::size_t multiplicationScratchSize(std::size_t length) {
+        if (length <= activeThresholds().karatsuba)
+            return 0;
+        if (length < activeThresholds().toom3)
+            return karatsubaScratchSize(length);
+        return toom3ScratchSize(length);
+    }
 
+    /**
+     * @brief Writes product of operands of the same size to result by method suited to their size
+     * @param result place for lhs.size() * 2 limbs of product
+     * @param scratch place for multiplicationScratchSize(lhs.size()) limbs of temporaries
+     */
+    void multiplyBalanced(BigNumView lhs, BigNumView rhs, Limb* result, Limb* scratch) {
+        if (lhs.begin() == rhs.begin()) {
+            squareBalanced(lhs, result, scratch);
+            return;
+        }
         const auto length = lhs.size();
-        std::vector<int64_t> result(length * 2);
+        if (length <= activeThresholds().karatsuba) {
+            kernels::basecaseMultiplication(lhs.begin(), length, rhs.begin(), length, result);
+        } else if (length < activeThresholds().toom3) {
+            karatsuba(lhs, rhs, result, scratch);
+        } else {
+            toom3(lhs, rhs, result, scratch);
+        }
+    }
+
+    /**
+     * @brief Writes square of num to result by method suited to its size
+     * @param result place for num.size() * 2 limbs of square
+     * @param scratch place for multiplicationScratchSize(num.size()) limbs of temporaries
+     */
+    void squareBalanced(BigNumView num, Limb* result, Limb* scratch) {
+        const auto length = num.size();
+        if (length <= activeThresholds().karatsuba) {
+            basecaseSquare(num.begin(), length, result);
+        } else if (length < activeThresholds().toom3) {
+            karatsubaSquare(num, result, scratch);
+        } else {
+            toom3(num, num, result, scratch);
+        }
+    }
+
+    /**
+     * @return Number of scratch limbs multiplyUnbalanced needs for operands of given sizes
+     */
+    std::size_t unbalancedScratchSize(std::size_t lhs_size, std::size_t rhs_size) {
+        const auto long_size = std::max(lhs_size, rhs_size);
+        const auto short_size = std::min(lhs_size, rhs_size);
+        if (long_size == short_size)
+            return multiplicationScratchSize(short_size);
+        if (short_size <= activeThresholds().karatsuba)
+            return 0;
+        // product of a chunk and whatever the chunks need themselves
+        return short_size * 2 + std::max(multiplicationScratchSize(short_size),
+                                         unbalancedScratchSize(short_size, long_size % short_size));
+    }
+
+    /**
+     * @brief Writes product of operands of any sizes to result. The longer one is sliced
+     *        into chunks of size of the shorter one, which are multiplied by balanced methods,
+     *        and the shorter leftover chunk is multiplied the same way with roles swapped
+     * @param result place for lhs.size() + rhs.size() limbs of product
+     * @param scratch place for unbalancedScratchSize(lhs.size(), rhs.size()) limbs of temporaries
+     */
+    void multiplyUnbalanced(BigNumView lhs, BigNumView rhs, Limb* result, Limb* scratch) {
+        if (lhs.size() < rhs.size()) {
+            std::swap(lhs, rhs);
+        }
+        const auto long_size = lhs.size();
+        const auto short_size = rhs.size();
+
+        if (long_size == short_size) {
+            multiplyBalanced(lhs, rhs, result, scratch);
+            return;
+        }
+        if (short_size <= activeThresholds().karatsuba) {
+            kernels::basecaseMultiplication(lhs.begin(), long_size, rhs.begin(), short_size, result);
+            return;
+        }
+
+        Limb* chunk_product = scratch;
+        Limb* rest = scratch + short_size * 2;
+
+        // the first chunk goes straight to result, the others are added to it
+        multiplyBalanced(BigNumView::untrimmed(lhs.begin(), short_size), rhs, result, rest);
+        std::fill(result + short_size * 2, result + long_size + short_size, 0);
+
+        std::size_t offset = short_size;
+        for (; offset + short_size <= long_size; offset += short_size) {
+            multiplyBalanced(BigNumView::untrimmed(lhs.begin() + offset, short_size),
+                             rhs, chunk_product, rest);
+            addShifted(result, long_size + short_size, chunk_product, short_size * 2, offset);
+        }
+        if (offset < long_size) {
+            multiplyUnbalanced(BigNumView::untrimmed(lhs.begin() + offset, long_size - offset), rhs,
+                               chunk_product, rest);
+            addShifted(result, long_size + short_size, chunk_product, long_size - offset + short_size, offset);
+        }
+    }
+
+    /**
+     * @brief Writes low size limbs of product of lhs and rhs of size limbs each to result,
+     *        only the columns below size are summed, which is half of the work
+     */
+    void basecaseLow(const Limb* lhs, const Limb* rhs, std::size_t size, Limb* result) {
+        mpn::ColumnSum sum;
+        mpn::mul_columns(lhs, size, rhs, size, 0, size, sum, result);
+    }
+
+    /**
+     * @brief Writes size + 1 limbs of lhs * rhs / 2^(64 * (size - 1)) for operands of size limbs to result.
+     *        Only the columns from size - 2 are summed, so the carry of the lower ones is lost
+     *        and the result may be less than the exact one by at most size
+     * @note Size must not be zero
+     */
+    void basecaseHigh(const Limb* lhs, const Limb* rhs, std::size_t size, Limb* result) {
+        const std::size_t lowest = size < 2 ? 0 : size - 2;
+        mpn::ColumnSum sum;
+        // the lowest column gives only its carry
+        Limb dropped = 0;
+        mpn::mul_columns(lhs, size, rhs, size, lowest, size - 1, sum, &dropped);
+        mpn::mul_columns(lhs, size, rhs, size, size - 1, size * 2 - 1, sum, result);
+        result[size] = sum.next();
+    }
+
+    /**
+     * @return Whether short product of given size is computed by columns
+     */
+    inline bool isShortBasecase(std::size_t size) {
+        // full products of the parts are computed by columns too until twice the threshold
+        return size / 2 <= activeThresholds().karatsuba;
+    }
+
+    /**
+     * @brief Size of the lower parts of operands in Mulders' short product, the product
+     *        of the upper ones is computed in full. Parts of about 0.3 and 0.7 of the size
+     *        make the short product about 0.8 of the full one under Karatsuba's method
+     */
+    inline std::size_t shortProductSplit(std::size_t size) {
+        return size * 3 / 10;
+    }
+
+    std::size_t lowProductScratchSize(std::size_t size) {
+        if (isShortBasecase(size))
+            return 0;
+        const auto low = shortProductSplit(size);
+        const auto high = size - low;
+        return high * 2 + std::max(multiplicationScratchSize(high), low + lowProductScratchSize(low));
+    }
+
+    /**
+     * @brief Writes lhs * rhs mod 2^(64 * size) for operands of size limbs to result.
+     *        Split lhs = a1 * x + a0 and rhs = b1 * x + b0, where a0 and b0 take the most of size,
+     *        then the low limbs are those of a0 * b0 + (a1 * b0 + a0 * b1) * x, whose second
+     *        term is two short products of the rest of size
+     * @param scratch place for lowProductScratchSize(size) limbs of temporaries
+     */
+    void lowProduct(const Limb* lhs, const Limb* rhs, std::size_t size, Limb* result, Limb* scratch) {
+        if (isShortBasecase(size)) {
+            basecaseLow(lhs, rhs, size, result);
+            return;
+        }
+        const auto high = size - shortProductSplit(size);
+        const auto low = size - high;
+
+        Limb* product = scratch;
+        Limb* cross = product + high * 2;
+        Limb* rest = cross + low;
+
+        // temporaries of short products are not needed yet, so the full one uses their place
+        multiplyBalanced(BigNumView::untrimmed(lhs, high), BigNumView::untrimmed(rhs, high), product, cross);
+        std::copy(product, product + size, result);
+
+        lowProduct(lhs + high, rhs, low, cross, rest);
+        mpn::add_n(result + high, result + high, cross, low);
+        lowProduct(lhs, rhs + high, low, cross, rest);
+        mpn::add_n(result + high, result + high, cross, low);
+    }
+
+    std::size_t highProductScratchSize(std::size_t size) {
+        if (isShortBasecase(size))
+            return 0;
+        const auto low = shortProductSplit(size);
+        const auto high = size - low;
+        return high * 2 + std::max(multiplicationScratchSize(high),
+                                   low * 2 + 3 + highProductScratchSize(low + 1));
+    }
+
+    /**
+     * @brief Writes size + 1 limbs of lhs * rhs / 2^(64 * (size - 1)) for operands of size limbs
+     *        to result, the value may be less than the exact one by at most size * 8.
+     *        Split lhs = a1 * x + a0 and rhs = b1 * x + b0, where a1 and b1 take the most of size,
+     *        so that a0 * b0 is below the result. Then a1 * b1 is computed in full and the upper
+     *        parts of a1 * b0 and a0 * b1 by short products of the rest of size
+     * @param scratch place for highProductScratchSize(size) limbs of temporaries
+     */
+    void highProduct(const Limb* lhs, const Limb* rhs, std::size_t size, Limb* result, Limb* scratch) {
+        if (isShortBasecase(size)) {
+            basecaseHigh(lhs, rhs, size, result);
+            return;
+        }
+        const auto low = shortProductSplit(size);
+        const auto high = size - low;
+
+        Limb* product = scratch;
+        Limb* low_part = product + high * 2;
+        Limb* cross = low_part + low + 1;
+        Limb* rest = cross + low + 2;
+
+        multiplyBalanced(BigNumView::untrimmed(lhs + low, high), BigNumView::untrimmed(rhs + low, high),
+                         product, low_part);
+        const auto dropped = size - 1 - low * 2;
+        std::copy(product + dropped, product + high * 2, result);
+
+        // limbs of a1 below its top low + 1 ones make less than a unit of the result with b0
+        const std::pair<const Limb*, const Limb*> parts[] = {{lhs, rhs}, {rhs, lhs}};
+        for (const auto& [first, second] : parts) {
+            std::fill(std::copy(second, second + low, low_part), low_part + low + 1, 0);
+            highProduct(first + size - low - 1, low_part, low + 1, cross, rest);
+            addShifted(result, size + 1, cross, low + 2, 0);
+        }
+    }
+
+    /**
+     * @brief Number of transformed limbs which fit the cache, transforms of
+     *        longer vectors are split into independent halves until they are that short
+     */
+    constexpr inline std::size_t NTT_BLOCK = 4096;
 
-        ArrayView lhsL(lhs.begin() + length / 2, lhs.end());
-        ArrayView rhsL(rhs.begin() + length / 2, rhs.end());
-        ArrayView lhsR(lhs.begin(), lhs.begin() + length / 2);
-        ArrayView rhsR(rhs.begin(), rhs.begin() + length / 2);
+    /**
+     * @brief Prime field modulo p = c * 2^k + 1 < 2^62 for number-theoretic transform.
+     *        Multiplication is done by Montgomery's method, so transformed values are
+     *        kept in form x * 2^64 mod p
+     */
+    class NttField
+    {
+    public:
+        NttField(Limb mod, Limb generator)
+            : _mod(mod)
+            , _negative_inverse(0)
+            , _square_of_base(0)
+            , _generator(generator) {
+            _negative_inverse = -mpn::binvert_limb(mod);
+            const Limb base = -mod % mod;
+            _square_of_base = static_cast<Limb>(static_cast<DoubleLimb>(base) * base % mod);
+        }
 
-        const auto c1 = karatsuba(lhsL, rhsL);
-        const auto c2 = karatsuba(lhsR, rhsR);
+        Limb mod() const {
+            return _mod;
+        }
 
-        std::vector<int64_t> lhsLR(length / 2);
-        std::vector<int64_t> rhsLR(length / 2);
+        /**
+         * @return Montgomery form of any limb, not necessarily less than mod
+         */
+        Limb toMontgomery(Limb num) const {
+            return _reduce(static_cast<DoubleLimb>(num) * _square_of_base);
+        }
 
-        for (auto i = 0; i < length / 2; ++i) {
-            lhsLR[i] = lhsL[i] + lhsR[i];
-            rhsLR[i] = rhsL[i] + rhsR[i];
+        Limb fromMontgomery(Limb num) const {
+            return _reduce(num);
         }
 
-        auto c3 = karatsuba(IntVectorView(lhsLR.begin(), lhsLR.end()),
-                            IntVectorView(rhsLR.begin(), rhsLR.end()));
+        /**
+         * @note Product of Montgomery form and ordinary number is ordinary
+         */
+        Limb multiply(Limb lhs, Limb rhs) const {
+            return _reduce(static_cast<DoubleLimb>(lhs) * rhs);
+        }
 
-        for (auto i = 0; i < length; ++i){
-            c3[i] -= c2[i] + c1[i];
+        Limb add(Limb lhs, Limb rhs) const {
+            const Limb sum = lhs + rhs;
+            return sum >= _mod ? sum - _mod : sum;
         }
 
-        for (auto i = 0; i < length; ++i) {
-            result[i] = c2[i];
+        Limb subtract(Limb lhs, Limb rhs) const {
+            return lhs >= rhs ? lhs - rhs : lhs + _mod - rhs;
         }
 
-        for (auto i = length; i < length * 2; ++i) {
-            result[i] = c1[i - length];
+        Limb pow(Limb num, Limb degree) const {
+            Limb result = toMontgomery(1);
+            for (; degree != 0; degree >>= 1) {
+                if (degree & 1) {
+                    result = multiply(result, num);
+                }
+                num = multiply(num, num);
+            }
+            return result;
         }
 
-        for (auto i = length / 2; i < length + length / 2; ++i) {
-            result[i] += c3[i - length / 2];
+        Limb inverse(Limb num) const {
+            return pow(num, _mod - 2);
         }
 
-        return result;
+        /**
+         * @return Montgomery form of primitive root of unity of given degree of two
+         */
+        Limb rootOfUnity(std::size_t degree) const {
+            return pow(toMontgomery(_generator), (_mod - 1) / degree);
+        }
+
+    private:
+        Limb _reduce(DoubleLimb num) const {
+            const Limb factor = static_cast<Limb>(num) * _negative_inverse;
+            const Limb result = static_cast<Limb>((num + static_cast<DoubleLimb>(factor) * _mod) >> LIMB_BITS);
+            return result >= _mod ? result - _mod : result;
+        }
+
+        Limb _mod;
+        Limb _negative_inverse;
+        Limb _square_of_base;
+        Limb _generator;
+    };
+
+    /**
+     * @brief Three primes whose product exceeds any coefficient of convolution of limbs
+     *        shorter than 2^55, along with their primitive roots
+     */
+    const NttField NTT_FIELDS[] = {
+        NttField(4179340454199820289ull, 3),  // 29 * 2^57 + 1
+        NttField(2485986994308513793ull, 5),  // 69 * 2^55 + 1
+        NttField(2053641430080946177ull, 7),  // 57 * 2^55 + 1
+    };
+
+    /**
+     * @brief Fills roots[half + j] with root^(size / half / 2 * j) for every
+     *        degree of two half < size and j < half, so every level of
+     *        transform finds its twiddle factors in a row
+     * @param root primitive root of unity of degree size
+     */
+    void nttRoots(const NttField& field, Limb root, Limb* roots, std::size_t size) {
+        const auto half = size / 2;
+        roots[half] = field.toMontgomery(1);
+        for (std::size_t j = 1; j < half; ++j) {
+            roots[half + j] = field.multiply(roots[half + j - 1], root);
+        }
+        for (std::size_t level = half / 2; level > 0; level /= 2) {
+            for (std::size_t j = 0; j < level; ++j) {
+                roots[level + j] = roots[2 * (level + j)];
+            }
+        }
     }
 
-    /*
-     * @brief Normalizing number ceils to NUM_BASE
+    /**
+     * @brief Decimation in frequency butterflies of a single level of forward transform
+     */
+    inline void nttForwardLevel(const NttField& field, Limb* data, std::size_t size,
+                                std::size_t half, const Limb* roots) {
+        for (std::size_t start = 0; start < size; start += half * 2) {
+            Limb* lower = data + start;
+            Limb* upper = lower + half;
+            for (std::size_t j = 0; j < half; ++j) {
+                const Limb u = lower[j];
+                const Limb v = upper[j];
+                lower[j] = field.add(u, v);
+                upper[j] = field.multiply(field.subtract(u, v), roots[half + j]);
+            }
+        }
+    }
+
+    /**
+     * @brief Decimation in time butterflies of a single level of inverse transform
      */
-    inline void finalize(std::vector<int64_t>& num) {
-        for (auto i = 0; i < num.size(); ++i) {
-            if (i != num.size() - 1) {
-                num[i + 1] += num[i] / NUM_BASE;
+    inline void nttInverseLevel(const NttField& field, Limb* data, std::size_t size,
+                                std::size_t half, const Limb* roots) {
+        for (std::size_t start = 0; start < size; start += half * 2) {
+            Limb* lower = data + start;
+            Limb* upper = lower + half;
+            for (std::size_t j = 0; j < half; ++j) {
+                const Limb u = lower[j];
+                const Limb v = field.multiply(upper[j], roots[half + j]);
+                lower[j] = field.add(u, v);
+                upper[j] = field.subtract(u, v);
             }
-            num[i] %= NUM_BASE;
+        }
+    }
+
+    /**
+     * @brief Transforms data in place leaving it in bit-reversed order
+     */
+    void nttForward(const NttField& field, Limb* data, std::size_t size, const Limb* roots) {
+        if (size <= NTT_BLOCK) {
+            for (std::size_t half = size / 2; half > 0; half /= 2) {
+                nttForwardLevel(field, data, size, half, roots);
+            }
+            return;
+        }
+        nttForwardLevel(field, data, size, size / 2, roots);
+        runProducts(size / 2, nullptr, 0,
+            [&](Limb*) { nttForward(field, data, size / 2, roots); },
+            [&](Limb*) { nttForward(field, data + size / 2, size / 2, roots); });
+    }
+
+    /**
+     * @brief Inverse of nttForward up to factor of size, takes data in bit-reversed order
+     * @param roots inverses of roots used by forward transform
+     */
+    void nttInverse(const NttField& field, Limb* data, std::size_t size, const Limb* roots) {
+        if (size <= NTT_BLOCK) {
+            for (std::size_t half = 1; half < size; half *= 2) {
+                nttInverseLevel(field, data, size, half, roots);
+            }
+            return;
+        }
+        runProducts(size / 2, nullptr, 0,
+            [&](Limb*) { nttInverse(field, data, size / 2, roots); },
+            [&](Limb*) { nttInverse(field, data + size / 2, size / 2, roots); });
+        nttInverseLevel(field, data, size, size / 2, roots);
+    }
+
+    /**
+     * @brief Writes cyclic convolution of lhs and rhs modulo prime of field to residues
+     * @param residues, buffer, roots, inverse_roots places for size limbs each
+     */
+    void nttConvolution(const NttField& field, const BigNumView& lhs, const BigNumView& rhs,
+                        std::size_t size, Limb* residues, Limb* buffer, Limb* roots, Limb* inverse_roots) {
+        const Limb root = field.rootOfUnity(size);
+        nttRoots(field, root, roots, size);
+        nttRoots(field, field.inverse(root), inverse_roots, size);
+
+        std::fill(std::transform(lhs.begin(), lhs.end(), residues,
+                                 [&field](Limb limb) { return field.toMontgomery(limb); }),
+                  residues + size, 0);
+        nttForward(field, residues, size, roots);
+
+        if (lhs.begin() == rhs.begin() && lhs.size() == rhs.size()) {
+            // square needs only one forward transform
+            std::copy(residues, residues + size, buffer);
+        } else {
+            std::fill(std::transform(rhs.begin(), rhs.end(), buffer,
+                                     [&field](Limb limb) { return field.toMontgomery(limb); }),
+                      buffer + size, 0);
+            nttForward(field, buffer, size, roots);
+        }
+
+        for (std::size_t i = 0; i < size; ++i) {
+            residues[i] = field.multiply(residues[i], buffer[i]);
+        }
+        nttInverse(field, residues, size, inverse_roots);
+
+        // multiplication by ordinary inverse of size also leaves Montgomery form
+        const Limb size_inverse = field.fromMontgomery(field.inverse(field.toMontgomery(size)));
+        for (std::size_t i = 0; i < size; ++i) {
+            residues[i] = field.multiply(residues[i], size_inverse);
+        }
+    }
+
+    /**
+     * @return Size of vector of limbs nttMultiplication transforms for given operands
+     */
+    std::size_t nttSize(std::size_t lhs_size, std::size_t rhs_size) {
+        std::size_t size = 1;
+        while (size < lhs_size + rhs_size - 1) {
+            size *= 2;
+        }
+        return size;
+    }
+
+    /**
+     * @return Number of scratch limbs nttMultiplication needs for operands of given sizes
+     */
+    std::size_t nttScratchSize(std::size_t lhs_size, std::size_t rhs_size) {
+        // residues modulo every prime and temporaries of convolutions running at once
+        return nttSize(lhs_size, rhs_size) * (3 + 3 * scratchCopies(std::min(lhs_size, rhs_size), 3));
+    }
+
+    /**
+     * @brief Multiplies numbers as polynomials of limbs modulo three primes by
+     *        number-theoretic transform and restores coefficients by Chinese remainder theorem
+     * @param result place for lhs.size() + rhs.size() limbs of product
+     * @param scratch place for nttScratchSize(lhs.size(), rhs.size()) limbs of temporaries
+     */
+    void nttMultiplication(const BigNumView& lhs, const BigNumView& rhs, Limb* result, Limb* scratch) {
+        const auto size = nttSize(lhs.size(), rhs.size());
+        Limb* residues[] = {scratch, scratch + size, scratch + size * 2};
+
+        // every convolution needs buffer, roots and their inverses
+        const auto convolution = [&](std::size_t prime) {
+            return [&, prime](Limb* own) {
+                nttConvolution(NTT_FIELDS[prime], lhs, rhs, size, residues[prime], own, own + size, own + size * 2);
+            };
+        };
+        runProducts(std::min(lhs.size(), rhs.size()), scratch + size * 3, size * 3,
+                    convolution(0), convolution(1), convolution(2));
+
+        // Garner's constants: x = r0 + p0 * t1 + p0 * p1 * t2
+        const NttField& field1 = NTT_FIELDS[1];
+        const NttField& field2 = NTT_FIELDS[2];
+        const Limb p0 = NTT_FIELDS[0].mod();
+        const Limb p1 = field1.mod();
+        const Limb p0_inverse_mod_p1 = field1.fromMontgomery(field1.inverse(field1.toMontgomery(p0)));
+        const Limb p0_mod_p2 = field2.toMontgomery(p0);
+        const Limb p0p1_inverse_mod_p2 = field2.fromMontgomery(
+                field2.inverse(field2.multiply(p0_mod_p2, field2.toMontgomery(p1))));
+        const DoubleLimb p0p1 = static_cast<DoubleLimb>(p0) * p1;
+
+        const std::size_t coefficients = lhs.size() + rhs.size() - 1;
+        Limb carry_low = 0;
+        Limb carry_high = 0;
+        for (std::size_t i = 0; i < coefficients; ++i) {
+            const Limb r0 = residues[0][i];
+            const Limb r0_mod_p2 = field2.toMontgomery(r0);
+            const Limb t1 = field1.multiply(field1.subtract(field1.toMontgomery(residues[1][i]),
+                                                            field1.toMontgomery(r0)),
+                                            p0_inverse_mod_p1);
+            const Limb t2 = field2.multiply(field2.subtract(field2.subtract(field2.toMontgomery(residues[2][i]),
+                                                                            r0_mod_p2),
+                                                            field2.multiply(field2.toMontgomery(t1), p0_mod_p2)),
+                                            p0p1_inverse_mod_p2);
+
+            // coefficient takes three limbs, carry from the previous ones two
+            const DoubleLimb low = static_cast<DoubleLimb>(p0) * t1 + r0;
+            const DoubleLimb high_part = static_cast<DoubleLimb>(static_cast<Limb>(p0p1)) * t2;
+            const DoubleLimb top_part = static_cast<DoubleLimb>(static_cast<Limb>(p0p1 >> LIMB_BITS)) * t2;
+
+            DoubleLimb sum = static_cast<DoubleLimb>(static_cast<Limb>(low)) + static_cast<Limb>(high_part) + carry_low;
+            result[i] = static_cast<Limb>(sum);
+            sum = (sum >> LIMB_BITS) + static_cast<Limb>(low >> LIMB_BITS)
+                  + static_cast<Limb>(high_part >> LIMB_BITS) + static_cast<Limb>(top_part) + carry_high;
+            carry_low = static_cast<Limb>(sum);
+            carry_high = static_cast<Limb>(sum >> LIMB_BITS) + static_cast<Limb>(top_part >> LIMB_BITS);
+        }
+        result[coefficients] = carry_low;
+    }
+
+    /**
+     * @brief Writes product of operands of any sizes, which may have leading zero limbs, to result
+     *        by method suited to their sizes
+     * @param result place for lhs_size + rhs_size limbs of product
+     * @note Temporaries are taken from ScratchWorkspace, so result must not be there
+     */
+    void multiplyTo(const Limb* lhs, std::size_t lhs_size, const Limb* rhs, std::size_t rhs_size, Limb* result) {
+        const BigNumView left(lhs, lhs_size);
+        const BigNumView right(rhs, rhs_size);
+        if (left.empty() || right.empty()) {
+            std::fill(result, result + lhs_size + rhs_size, 0);
+            return;
+        }
+        // transform pays off only when both operands are long
+        if (std::min(left.size(), right.size()) >= activeThresholds().ntt) {
+            const ScratchWorkspace scratch(nttScratchSize(left.size(), right.size()));
+            nttMultiplication(left, right, result, scratch.data());
+        } else {
+            const ScratchWorkspace scratch(unbalancedScratchSize(left.size(), right.size()));
+            multiplyUnbalanced(left, right, result, scratch.data());
+        }
+        std::fill(result + left.size() + right.size(), result + lhs_size + rhs_size, 0);
+    }
+
+    /**
+     * @brief Recursive division of Burnikel and Ziegler of num of size * 2 limbs by normalized divisor.
+     *        The top half of quotient is the quotient of the top part of num by the top half of divisor,
+     *        which is then corrected by its product with the low half of divisor, and the low half
+     *        of quotient is found from the rest the same way. So the work is two divisions and two
+     *        products of half size, and division follows the cost of multiplication
+     * @param inverse mpn::invert_limb of the top limb of divisor, which all of its top parts share
+     * @param quotient place for size limbs
+     * @param scratch place for size limbs of products
+     * @return The top limb of quotient, 0 or 1, which is not written to quotient.
+     *         The remainder replaces the low size limbs of num
+     * @note The top size limbs of num must not be greater than divisor
+     */
+    Limb divideRecursive(Limb* num, const Limb* divisor, std::size_t size, Limb inverse,
+                         Limb* quotient, Limb* scratch) {
+        if (size < activeThresholds().division) {
+            return divideSchoolbook(num, size * 2, divisor, size, inverse, quotient);
+        }
+        const std::size_t low = size / 2;
+        const std::size_t high = size - low;
+
+        Limb top = divideRecursive(num + low * 2, divisor + low, high, inverse, quotient + low, scratch);
+        multiplyTo(quotient + low, high, divisor, low, scratch);
+        Limb borrow = mpn::sub_n(num + low, num + low, scratch, size);
+        if (top != 0) {
+            borrow += mpn::sub_n(num + size, num + size, divisor, low);
+        }
+        // estimate by the top half of divisor exceeds the quotient by at most two
+        while (borrow != 0) {
+            top -= mpn::sub_1(quotient + low, quotient + low, high, 1);
+            borrow -= mpn::add_n(num + low, num + low, divisor, size);
+        }
+
+        const Limb low_top = divideRecursive(num + high, divisor + high, low, inverse, quotient, scratch);
+        multiplyTo(quotient, low, divisor, high, scratch);
+        borrow = mpn::sub_n(num, num, scratch, size);
+        if (low_top != 0) {
+            borrow += mpn::sub_n(num + low, num + low, divisor, high);
+        }
+        // the rest is less than divisor now, so the corrected low half fits its limbs
+        // and the limb borrowed out of it is the top one it had
+        while (borrow != 0) {
+            mpn::sub_1(quotient, quotient, low, 1);
+            borrow -= mpn::add_n(num, num, divisor, size);
+        }
+        return top;
+    }
+
+    /**
+     * @brief Division of num of size + quotient_size limbs by normalized divisor of size limbs
+     *        for quotient not longer than divisor. Quotient is estimated by division of the top
+     *        parts of num and divisor and corrected like in divideRecursive
+     * @param quotient place for quotient_size limbs
+     * @param scratch place for size limbs of products
+     * @note The top size limbs of num must be less than divisor, the remainder replaces the low ones
+     */
+    void divideShort(Limb* num, std::size_t quotient_size, const Limb* divisor, std::size_t size, Limb inverse,
+                     Limb* quotient, Limb* scratch) {
+        if (quotient_size < activeThresholds().division) {
+            divideSchoolbook(num, size + quotient_size, divisor, size, inverse, quotient);
+            return;
+        }
+        const std::size_t rest = size - quotient_size;
+        const Limb top = divideRecursive(num + rest, divisor + rest, quotient_size, inverse, quotient, scratch);
+        if (rest == 0) {
+            return;
+        }
+        multiplyTo(quotient, quotient_size, divisor, rest, scratch);
+        Limb borrow = mpn::sub_n(num, num, scratch, size);
+        if (top != 0) {
+            borrow += mpn::sub_n(num + quotient_size, num + quotient_size, divisor, rest);
+        }
+        while (borrow != 0) {
+            mpn::sub_1(quotient, quotient, quotient_size, 1);
+            borrow -= mpn::add_n(num, num, divisor, size);
+        }
+    }
+
+    /**
+     * @return Num times 2^(64 * count)
+     */
+    BigNum shiftedByLimbs(BigNumView num, std::size_t count) {
+        LimbBuffer limbs(count + num.size(), LimbResourceScope::current());
+        std::copy(num.begin(), num.end(), limbs.begin() + count);
+        return BigNum(BigNumView(limbs.data(), limbs.size()));
+    }
+
+    /**
+     * @return Num / 2^(64 * count) rounded down, which shares limbs with num
+     */
+    BigNumView droppedLimbs(BigNumView num, std::size_t count) {
+        count = std::min(count, num.size());
+        return BigNumView(num.data() + count, num.size() - count);
+    }
+
+    /**
+     * @brief Reciprocal by Newton's iteration x + x * (1 - divisor * x), every step of which doubles
+     *        the number of correct limbs. Half of them come from the reciprocal of the top limbs
+     *        of divisor rounded up, so the approximation is below the exact one, and the step
+     *        never overshoots either
+     * @return 2^(64 * exponent) / divisor less than the exact one by a few units at most
+     */
+    BigNum approximateReciprocal(BigNumView divisor, std::size_t exponent) {
+        const std::size_t size = divisor.size();
+        // the quotient here has exponent - size + 2 limbs, which is shorter than the threshold,
+        // so it is not divided by reciprocal again
+        if (exponent < size || exponent - size + 2 < activeThresholds().newton) {
+            const BigNum power = shiftedByLimbs(1_bn, exponent);
+            if (power < divisor) {
+                return BigNum();
+            }
+            LimbBuffer quotient(exponent - size + 2, LimbResourceScope::current());
+            LimbBuffer remainder(size, LimbResourceScope::current());
+            LimbBuffer normalized(size, LimbResourceScope::current());
+            divideLimbs(power, prepareDivisor(divisor, normalized.data()), quotient.data(), remainder.data());
+            return BigNum(BigNumView(quotient.data(), quotient.size()));
+        }
+
+        // divisor longer than reciprocal is rounded up to its top limbs, which changes the result
+        // by less than a unit
+        const std::size_t precision = exponent - size;
+        if (size > precision + 3) {
+            const std::size_t dropped = size - precision - 3;
+            return approximateReciprocal(droppedLimbs(divisor, dropped) + 1_bn, exponent - dropped);
+        }
+        // reciprocal has precision + 1 limbs, half of them come from two more top limbs of divisor
+        const std::size_t half = (precision + 1) / 2 + 1;
+        const BigNum approximation = size > half + 2
+            ? approximateReciprocal(droppedLimbs(divisor, size - half - 2) + 1_bn, half * 2 + 2)
+            : approximateReciprocal(divisor, size + half);
+
+        // x is the approximation times 2^(64 * (precision - half)), so the error 1 - divisor * x
+        // and the step are computed for the approximation itself, the step is
+        // approximation * error / 2^(64 * (size + half * 2 - precision)), and the lower limbs
+        // of error change it by less than a unit
+        const BigNum error = shiftedByLimbs(1_bn, size + half) - divisor * approximation;
+        const std::size_t shift = size + half * 2 - precision;
+        const std::size_t dropped = size + half > precision + 1 ? size + half - precision - 1 : 0;
+        return shiftedByLimbs(approximation, precision - half)
+               + mulhi(approximation, droppedLimbs(error, dropped), shift - dropped);
+    }
+
+    /**
+     * @brief Division by reciprocal of divisor, which takes a few products of the size of quotient
+     */
+    std::pair<BigNum, BigNum> newtonDivision(BigNumView num, BigNumView divisor) {
+        const std::size_t size = divisor.size();
+        const std::size_t quotient_size = num.size() - size + 1;
+        // the top limbs of num times reciprocal are less than quotient by a few units
+        const BigNum inverse = approximateReciprocal(divisor, size + quotient_size);
+        BigNum quotient = mulhi(droppedLimbs(num, size - 1), inverse, quotient_size + 1);
+        BigNum remainder = num - quotient * divisor;
+        while (remainder >= divisor) {
+            remainder -= divisor;
+            quotient += 1_bn;
+        }
+        return std::pair(std::move(quotient), std::move(remainder));
+    }
+
+    void divideLimbs(BigNumView num, const DivisorLimbs& divisor, Limb* quotient, Limb* remainder) {
+        const std::size_t size = divisor.value.size();
+        const std::size_t quotient_size = num.size() - size + 1;
+        if (size == 1) {
+            remainder[0] = mpn::divrem_1_preinv(quotient, num.data(), num.size(), divisor.normalized[0],
+                                                divisor.shift, divisor.inverse);
+            return;
+        }
+        if (std::min(size, quotient_size) >= activeThresholds().newton) {
+            const auto [whole, rest] = newtonDivision(num, divisor.value);
+            const BigNumView whole_view = whole;
+            const BigNumView rest_view = rest;
+            std::fill(std::copy(whole_view.begin(), whole_view.end(), quotient), quotient + quotient_size, 0);
+            std::fill(std::copy(rest_view.begin(), rest_view.end(), remainder), remainder + size, 0);
+            return;
+        }
+        const unsigned shift = divisor.shift;
+        const Limb* normalized = divisor.normalized;
+
+        // num is shifted like divisor, then the top size limbs of the rest are less than divisor,
+        // as its top limb gets only the bits shifted out. Product of two numbers of inline size
+        // fits inline as well, so reductions of such products do not allocate
+        LimbVector<2 * BigNum::INLINE_LIMBS + 1> rest(num.size() + 1);
+        if (shift != 0) {
+            rest.back() = mpn::lshift(rest.data(), num.data(), num.size(), shift);
+        } else {
+            std::copy(num.begin(), num.end(), rest.begin());
+        }
+
+        if (size < activeThresholds().division || quotient_size < activeThresholds().division) {
+            divideSchoolbook(rest.data(), rest.size(), normalized, size, divisor.inverse, quotient);
+        } else {
+            // quotient is found by blocks of size limbs from the top like by schoolbook method
+            // on digits of 2^(64 * size), the shorter block goes first
+            LimbBuffer scratch(size, LimbResourceScope::current());
+            std::size_t block = quotient_size % size == 0 ? size : quotient_size % size;
+            for (std::size_t offset = quotient_size; offset > 0; block = size) {
+                offset -= block;
+                divideShort(rest.data() + offset, block, normalized, size, divisor.inverse,
+                            quotient + offset, scratch.data());
+            }
+        }
+
+        if (shift != 0) {
+            mpn::rshift(remainder, rest.data(), size, shift);
+        } else {
+            std::copy(rest.begin(), rest.begin() + size, remainder);
         }
     }
 
     /*
-    *  @return Pair of x, y
+    *  @return Pair of exact signed x, y
     *          ax + by = gcd(a, b)
     */
-    std::pair<BigNum, BigNum> extendedEuclid(const BigNum& a, const BigNum& b, const BigNum& mod) {
+    std::pair<BigInt, BigInt> extendedEuclid(BigNumView a, BigNumView b) {
 
         if (b == BigNum("0")) {
-            return std::pair(BigNum("1"), BigNum("0"));
+            return std::pair(BigInt(1_bn), BigInt());
         }
         const auto [int_part, remainder] = extract(a, b);
-        const auto [x, y] = extendedEuclid(b, remainder, mod);
-        return std::pair(y, subtract(x, (int_part * y) % mod, mod));
+        auto [x, y] = extendedEuclid(b, remainder);
+        x -= BigInt(int_part) * y;
+        return std::pair(std::move(y), std::move(x));
     }
 
-    BigNum gcd(const BigNum& lhs, const BigNum& rhs) {
+    BigNum gcd(BigNumView lhs, BigNumView rhs) {
         if (lhs == BigNum("0")) {
-            return rhs;
+            return BigNum(rhs);
         }
         return gcd (rhs % lhs, lhs);
     }
 
-    bool isPrime(const BigNum& num) {
+    bool isPrime(BigNumView num) {
         if (num <= 1_bn) {
             return false;
         }
@@ -544,7 +1807,7 @@ namespace {
             return false;
         }
 
-        for (auto i = 5_bn; i * i <= num; i = i + 6_bn) {
+        for (auto i = 5_bn; i * i <= num; i += 6_bn) {
             if (num % i == 0_bn || num % (i + 2_bn) == 0_bn) {
                 return false;
             }
@@ -552,53 +1815,177 @@ namespace {
         return true;
     }
 
-    BigNum pow(const BigNum& num, const BigNum& degree, const BigNum& mod) {
+    /**
+     * @brief Power modulo odd mod by Montgomery's method, every product is reduced
+     *        by rows of multiply-accumulate instead of division. Numbers are kept
+     *        in form x * 2^(64 * mod.size()) modulo mod
+     */
+    BigNum montgomeryPow(BigNumView num, BigNumView degree, BigNumView mod) {
+        const auto size = mod.size();
+        const Limb inverse = 0 - mpn::binvert_limb(mod[0]);
+
+        LimbBuffer product(size * 2, LimbResourceScope::current());
+        const auto reduceTo = [&](LimbBuffer& result) {
+            kernels::montgomeryReduce(product.data(), mod.data(), size, inverse);
+            std::copy(product.begin() + size, product.end(), result.begin());
+        };
+        const auto multiplyReduceTo = [&](BigNumView lhs, BigNumView rhs, LimbBuffer& result) {
+            const BigNum full = lhs * rhs;
+            const BigNumView limbs = full;
+            std::fill(std::copy(limbs.begin(), limbs.end(), product.begin()), product.end(), 0);
+            reduceTo(result);
+        };
+
+        LimbBuffer square_of_base(size * 2 + 1, LimbResourceScope::current());
+        square_of_base.back() = 1;
+        const BigNum base_square_num = BigNumView(square_of_base.data(), square_of_base.size()) % mod;
+        const BigNumView base_square = base_square_num;
+
+        LimbBuffer base(size, LimbResourceScope::current());
+        LimbBuffer result(size, LimbResourceScope::current());
+        multiplyReduceTo(num % mod, base_square, base);
+        // 2^(64 * size) is the form of 1
+        std::fill(std::copy(base_square.begin(), base_square.end(), product.begin()), product.end(), 0);
+        reduceTo(result);
+
+        const BigNumView base_view(base.data(), size);
+        for (std::size_t limb = degree.size(); limb-- > 0;) {
+            for (int bit = LIMB_BITS - 1; bit >= 0; --bit) {
+                const BigNumView result_view(result.data(), size);
+                multiplyReduceTo(result_view, result_view, result);
+                if (((degree[limb] >> bit) & 1) != 0) {
+                    multiplyReduceTo(BigNumView(result.data(), size), base_view, result);
+                }
+            }
+        }
+
+        std::fill(std::copy(result.begin(), result.end(), product.begin()), product.end(), 0);
+        reduceTo(result);
+        return BigNum(BigNumView(result.data(), size));
+    }
+
+    BigNum pow(BigNumView num, BigNumView degree, BigNumView mod) {
         if (degree == 0_bn) {
             return 1_bn;
         }
+        if (!mod.empty() && mod[0] % 2 != 0) {
+            return montgomeryPow(num, degree, mod);
+        }
 
-        auto result = pow(num, extract(degree, 2_bn).first, mod) % mod;
-        result = (result * result) % mod;
-        return degree % 2_bn == 0_bn ? result : (result * num) % mod;
+        auto result = pow(num, extract(degree, 2_bn).first, mod);
+        modifyMultiply(result, result, mod);
+        if (degree % 2_bn != 0_bn) {
+            modifyMultiply(result, num, mod);
+        }
+        return result;
     }
 }
 
-BigNum operator* (const BigNum& lhs, const BigNum& rhs) {
+BigNum operator*(BigNumView lhs, BigNumView rhs) {
+
+    if (lhs.empty() || rhs.empty()) {
+        return BigNum();
+    }
 
-    std::vector<int64_t> lhsTemp(lhs._digits.begin(), lhs._digits.end());
-    std::vector<int64_t> rhsTemp(rhs._digits.begin(), rhs._digits.end());
-    auto maxSize = std::max(lhsTemp.size(), rhsTemp.size());
+    BigNum result;
+    result._digits.resize(lhs.size() + rhs.size());
+    multiplyTo(lhs.data(), lhs.size(), rhs.data(), rhs.size(), result._digits.data());
 
-    lhsTemp.resize(upperLog2(maxSize));
-    rhsTemp.resize(upperLog2(maxSize));
+    while (!result._digits.empty() && result._digits.back() == 0) {
+        result._digits.pop_back();
+    }
+    return result;
+}
 
-    auto nums = karatsuba(IntVectorView(lhsTemp.begin(), lhsTemp.end()),
-                          IntVectorView(rhsTemp.begin(), rhsTemp.end()));
-    finalize(nums);
+BigNum square(BigNumView num) {
+    return num * num;
+}
 
-    while (!nums.empty() && nums.back() == 0) {
-        nums.pop_back();
+BigNum mullo(BigNumView lhs, BigNumView rhs, std::size_t size) {
+    // limbs above size do not reach the low part of product
+    lhs = BigNumView(lhs.data(), std::min(lhs.size(), size));
+    rhs = BigNumView(rhs.data(), std::min(rhs.size(), size));
+    if (lhs.empty() || rhs.empty()) {
+        return BigNum();
+    }
+    if (size >= activeThresholds().ntt) {
+        const BigNum product = lhs * rhs;
+        return BigNum(BigNumView(product._digits.data(), std::min(product._digits.size(), size)));
     }
 
+    const ScratchWorkspace scratch(size * 2 + lowProductScratchSize(size));
+    Limb* operands = scratch.data();
+    std::fill(std::copy(lhs.begin(), lhs.end(), operands), operands + size, 0);
+    std::fill(std::copy(rhs.begin(), rhs.end(), operands + size), operands + size * 2, 0);
+
     BigNum result;
-    result._digits = std::vector<int>(nums.begin(), nums.end());
+    result._digits.resize(size);
+    lowProduct(operands, operands + size, size, result._digits.data(), operands + size * 2);
+    removeLeadingZeros(result._digits);
     return result;
 }
 
-BigNum multiply(const BigNum& lhs, const BigNum& rhs, const BigNum& mod) {
-        return (lhs % mod * rhs % mod) % mod;
+BigNum mulhi(BigNumView lhs, BigNumView rhs, std::size_t size) {
+    if (lhs.empty() || rhs.empty() || lhs.size() + rhs.size() <= size) {
+        return BigNum();
+    }
+    const auto fullProduct = [&] {
+        const BigNum product = lhs * rhs;
+        const auto dropped = std::min(product._digits.size(), size);
+        return BigNum(BigNumView(product._digits.data() + dropped, product._digits.size() - dropped));
+    };
+    if (lhs.size() > size || rhs.size() > size || size >= activeThresholds().ntt) {
+        return fullProduct();
+    }
+
+    const ScratchWorkspace scratch(size * 3 + 1 + highProductScratchSize(size));
+    Limb* operands = scratch.data();
+    Limb* approximation = operands + size * 2;
+    std::fill(std::copy(lhs.begin(), lhs.end(), operands), operands + size, 0);
+    std::fill(std::copy(rhs.begin(), rhs.end(), operands + size), operands + size * 2, 0);
+    highProduct(operands, operands + size, size, approximation, approximation + size + 1);
+
+    // the lowest limb is a guard, unless the error may carry out of it the rest is exact
+    if (approximation[0] > ~Limb(0) - size * 8) {
+        return fullProduct();
+    }
+    return BigNum(BigNumView(approximation + 1, size));
+}
+
+BigNum reciprocal(BigNumView num, std::size_t precision) {
+    if (num.empty()) {
+        throw std::invalid_argument("Division by zero.");
+    }
+    BigNum result = approximateReciprocal(num, precision);
+    BigNum rest = shiftedByLimbs(1_bn, precision) - num * result;
+    while (rest >= num) {
+        rest -= num;
+        result += 1_bn;
+    }
+    return result;
+}
+
+const Thresholds& Thresholds::current() {
+    return activeThresholds();
+}
+
+void Thresholds::set(const Thresholds& thresholds) {
+    activeThresholds() = sanitized(thresholds);
+}
+
+BigNum multiply(BigNumView lhs, BigNumView rhs, BigNumView mod) {
+    BigNum result(lhs);
+    modifyMultiply(result, rhs, mod);
+    return result;
 }
 
-BigNum inverted(const BigNum &num, const BigNum& mod,
+BigNum inverted(BigNumView num, BigNumView mod,
                                    BigNum::InversionPolicy policy = BigNum::InversionPolicy::Euclid){
 
     if (policy == BigNum::InversionPolicy::Euclid) {
         if (gcd(num, mod) != 1_bn)
             throw std::invalid_argument("Nums must be coprime.");
-        auto inverted_ = extendedEuclid(num, mod, mod).first;
-        while (!inverted_._digits.empty() && inverted_._digits.back() == 0)
-            inverted_._digits.pop_back();
-        return inverted_;
+        return residue(extendedEuclid(num, mod).first, mod);
     } else {
         if (!isPrime(mod)) {
             throw std::invalid_argument("Mod must be prime.");
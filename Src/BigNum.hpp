@@ -4,48 +4,166 @@
 #include <iostream>
 #include <algorithm>
 #include <string>
+#include <string_view>
+#include <cstdint>
 #include <cmath>
+#include <array>
+#include <limits>
+#include <utility>
+#include <stdexcept>
+
+#include <LimbVector.hpp>
 
 namespace lab {
 
+class BigNum;
+class Divisor;
+
+/**
+ * @brief Non-owning read-only view of limbs of a number, least significant first,
+ *        e.g. limbs inside a network buffer. Leading zero limbs are ignored
+ */
+class BigNumView
+{
+public:
+    BigNumView(const Limb* limbs, std::size_t size)
+        : _data(limbs)
+        , _size(size) {
+        while (_size != 0 && _data[_size - 1] == 0) {
+            --_size;
+        }
+    }
+
+    BigNumView(const BigNum& num);
+
+    /**
+     * @return View of exactly size limbs with leading zeros kept, for routines which split
+     *         operands into parts of fixed size
+     */
+    static BigNumView untrimmed(const Limb* limbs, std::size_t size) {
+        BigNumView view(limbs, 0);
+        view._size = size;
+        return view;
+    }
+
+    const Limb* data() const { return _data; }
+    std::size_t size() const { return _size; }
+    bool empty() const { return _size == 0; }
+
+    const Limb* begin() const { return _data; }
+    const Limb* end() const { return _data + _size; }
+
+    const Limb& operator[](std::size_t n) const { return _data[n]; }
+
+private:
+    const Limb* _data;
+    std::size_t _size;
+};
+
 /**
  * @brief Class for holding big positive integers
  */
 class BigNum
 {
 public:
+    /**
+     * @brief Number of limbs stored without heap allocation,
+     *        enough for product of two 256-bit numbers
+     */
+    static constexpr std::size_t INLINE_LIMBS = 8;
+
     BigNum(const BigNum& that) = default;
 
+    BigNum(BigNum&& that) noexcept = default;
+
     BigNum(std::string_view num_str);
 
     BigNum() = default;
 
+    /**
+     * @brief Copies limbs of view
+     */
+    explicit BigNum(BigNumView view);
+
     BigNum& operator=(const BigNum& that) = default;
 
-    friend std::string to_string(const BigNum& num);
+    BigNum& operator=(BigNum&& that) = default;
+
+    BigNum& operator+=(BigNumView other);
+
+    /**
+     * @note this number must be bigger than other
+     */
+    BigNum& operator-=(BigNumView other);
+
+    BigNum& operator*=(BigNumView other);
+
+    BigNum& operator*=(int other);
+
+    BigNum& operator%=(BigNumView mod);
+
+    friend std::string to_string(BigNumView num);
     friend BigNum from_string(std::string_view str);
 
     static const BigNum& inf();
 
-    friend bool operator<(const BigNum& left, const BigNum& right);
-    friend bool operator<=(const BigNum& left, const BigNum& right);
-    friend bool operator>(const BigNum& left, const BigNum& right);
-    friend bool operator>=(const BigNum& left, const BigNum& right);
-    friend bool operator==(const BigNum& left, const BigNum& right);
-    friend bool operator!=(const BigNum& left, const BigNum& right);
+    friend bool operator<(BigNumView left, BigNumView right);
+    friend bool operator<=(BigNumView left, BigNumView right);
+    friend bool operator>(BigNumView left, BigNumView right);
+    friend bool operator>=(BigNumView left, BigNumView right);
+    friend bool operator==(BigNumView left, BigNumView right);
+    friend bool operator!=(BigNumView left, BigNumView right);
 
     /**
      * @note left number must be bigger than right number
      */
-    friend BigNum operator-(const BigNum& left, const BigNum& right);
+    friend BigNum operator-(BigNumView left, BigNumView right);
+    friend BigNum operator-(BigNum&& left, BigNumView right);
+    friend BigNum operator-(BigNumView left, BigNum&& right);
+    friend BigNum operator-(BigNum&& left, BigNum&& right);
 
-    friend BigNum operator+(const BigNum& left, const BigNum& right);
+    /**
+     * @note Overloads taking rvalues write result to the buffer of expiring operand
+     */
+    friend BigNum operator+(BigNumView left, BigNumView right);
+    friend BigNum operator+(BigNum&& left, BigNumView right);
+    friend BigNum operator+(BigNumView left, BigNum&& right);
+    friend BigNum operator+(BigNum&& left, BigNum&& right);
 
     friend BigNum operator*(const BigNum& left, int right);
+    friend BigNum operator*(BigNum&& left, int right);
 
-    friend BigNum operator* (const BigNum &left, const BigNum &right);
+    /**
+     * @note Product of number by itself is computed by squaring
+     */
+    friend BigNum operator*(BigNumView left, BigNumView right);
 
-    friend BigNum operator%(const BigNum& left, const BigNum& right);
+    /**
+     * @brief Squaring computes every cross product of limbs once and doubles it
+     */
+    friend BigNum square(BigNumView num);
+
+    /**
+     * @brief Short product, only limbs below size are computed, which takes about half of the work
+     * @return lhs * rhs mod 2^(64 * size)
+     */
+    friend BigNum mullo(BigNumView lhs, BigNumView rhs, std::size_t size);
+
+    /**
+     * @brief Short product, limbs below size are only estimated, which takes about half of the work
+     *        when neither operand is longer than size
+     * @return lhs * rhs / 2^(64 * size) rounded down
+     */
+    friend BigNum mulhi(BigNumView lhs, BigNumView rhs, std::size_t size);
+
+    /**
+     * @brief Fixed-point reciprocal, long ones are found by Newton's iteration with doubling precision
+     * @return 2^(64 * precision) / num rounded down
+     * @throws std::invalid_argument if num is zero
+     */
+    friend BigNum reciprocal(BigNumView num, std::size_t precision);
+
+    friend BigNum operator%(BigNumView left, BigNumView right);
 
     template<typename OStream>
     friend OStream& operator<<(OStream& os, const BigNum& num);
@@ -55,29 +173,74 @@ public:
     /**
      * @brief Converts number to a corresponding in group modulo mod
      */
-    friend void modify(BigNum& num, const BigNum& mod);
+    friend void modify(BigNum& num, BigNumView mod);
+
+    /**
+     * @brief In-place modulo addition, num becomes (num + other) modulo mod
+     */
+    friend void modifyAdd(BigNum& num, BigNumView other, BigNumView mod);
+
+    /**
+     * @brief In-place modulo subtraction, num becomes (num - other) modulo mod
+     */
+    friend void modifySubtract(BigNum& num, BigNumView other, BigNumView mod);
+
+    /**
+     * @brief In-place modulo multiplication, num becomes (num * other) modulo mod
+     */
+    friend void modifyMultiply(BigNum& num, BigNumView other, BigNumView mod);
 
     /**
      * @brief Modulo addition
      */
-    friend BigNum add(const BigNum& first, const BigNum& second, const BigNum& mod);
+    friend BigNum add(BigNumView first, BigNumView second, BigNumView mod);
 
     /**
      * @brief Modulo subtraction
      */
-    friend BigNum subtract(const BigNum& first, const BigNum& second, const BigNum& mod);
+    friend BigNum subtract(BigNumView first, BigNumView second, BigNumView mod);
 
 
     /**
      *  @brief Multiplication of two numbers by Karatsuba or Montgomery algorithm
      */
-    friend BigNum multiply (const BigNum& lhs, const BigNum& rhs, const BigNum& mod);
+    friend BigNum multiply(BigNumView lhs, BigNumView rhs, BigNumView mod);
 
     /**
     * @brief Division of two numbers
     * @return Pair of numbers, the first is an integer, the second is a remainder of division
     */
-    friend std::pair<BigNum, BigNum> extract(const BigNum& first, const BigNum& second);
+    friend std::pair<BigNum, BigNum> extract(BigNumView first, BigNumView second);
+
+    /**
+     * @brief Division by divisor prepared once, for many numbers reduced by the same modulus
+     * @return Pair of quotient and remainder
+     */
+    friend std::pair<BigNum, BigNum> extract(BigNumView num, const Divisor& divisor);
+
+    /**
+     * @return Remainder of num by divisor prepared once
+     */
+    friend BigNum operator%(BigNumView num, const Divisor& divisor);
+
+    /**
+     * @brief Converts number to a corresponding in group modulo mod prepared once
+     */
+    friend void modify(BigNum& num, const Divisor& mod);
+
+    /**
+     * @brief Modulo operations by modulus prepared once, same as the ones taking BigNumView
+     */
+    friend void modifyAdd(BigNum& num, BigNumView other, const Divisor& mod);
+    friend void modifySubtract(BigNum& num, BigNumView other, const Divisor& mod);
+    friend void modifyMultiply(BigNum& num, BigNumView other, const Divisor& mod);
+
+    /**
+     * @brief Division by a single limb, which extract and % take for divisors of one limb
+     * @return Pair of quotient and remainder
+     * @throws std::invalid_argument if divisor is zero
+     */
+    friend std::pair<BigNum, Limb> divmod_1(BigNumView num, Limb divisor);
 
     /**
      *  @brief Euclid method requires number and module to be coprime,
@@ -91,14 +254,14 @@ public:
     /**
      *  @return Inverted number to num in group modulo mod
      */
-    friend BigNum inverted(const BigNum &num, const BigNum& mod, InversionPolicy policy);
+    friend BigNum inverted(BigNumView num, BigNumView mod, InversionPolicy policy);
 
 
      /**
       * @brief Converts number to vector of its digits
       * @return Vector of digits
       */
-    friend std::vector<char> toOneDigit(const BigNum& num);
+    friend std::vector<char> toOneDigit(BigNumView num);
 
     /**
      * @brief Converts vector of digits to number
@@ -106,19 +269,282 @@ public:
     friend BigNum toBigNum(std::vector<char>& num_digits);
 
 private:
-    ///< Array of coefficients in representation
-    std::vector<int> _digits;
+    template <std::size_t Bits>
+    friend class FixedNum;
+
+    friend class BigNumView;
+    friend class Divisor;
+
+    ///< Array of coefficients in representation, least significant first
+    LimbVector<INLINE_LIMBS> _digits;
+};
+
+inline BigNumView::BigNumView(const BigNum& num)
+    : _data(num._digits.data())
+    , _size(num._digits.size()) {
+}
+
+// operations on views are redeclared here, so that they are found without BigNum arguments
+std::string to_string(BigNumView num);
+bool operator<(BigNumView left, BigNumView right);
+bool operator<=(BigNumView left, BigNumView right);
+bool operator>(BigNumView left, BigNumView right);
+bool operator>=(BigNumView left, BigNumView right);
+bool operator==(BigNumView left, BigNumView right);
+bool operator!=(BigNumView left, BigNumView right);
+BigNum operator-(BigNumView left, BigNumView right);
+BigNum operator+(BigNumView left, BigNumView right);
+BigNum operator*(BigNumView left, BigNumView right);
+BigNum square(BigNumView num);
+BigNum mullo(BigNumView lhs, BigNumView rhs, std::size_t size);
+BigNum mulhi(BigNumView lhs, BigNumView rhs, std::size_t size);
+BigNum reciprocal(BigNumView num, std::size_t precision);
+BigNum operator%(BigNumView left, BigNumView right);
+BigNum add(BigNumView first, BigNumView second, BigNumView mod);
+BigNum subtract(BigNumView first, BigNumView second, BigNumView mod);
+BigNum multiply(BigNumView lhs, BigNumView rhs, BigNumView mod);
+std::pair<BigNum, BigNum> extract(BigNumView first, BigNumView second);
+std::pair<BigNum, BigNum> extract(BigNumView num, const Divisor& divisor);
+BigNum operator%(BigNumView num, const Divisor& divisor);
+std::pair<BigNum, Limb> divmod_1(BigNumView num, Limb divisor);
+std::vector<char> toOneDigit(BigNumView num);
+
+/**
+ * @brief Divisor with everything division needs computed once: the divisor shifted so that
+ *        its top bit is set, and the inverse of its top limb. Repeated reductions by the same
+ *        modulus, e.g. in a chain of modulo operations, take it instead of the modulus itself
+ * @note Holds a copy of the divisor, so it may outlive the number it is made of
+ */
+class Divisor
+{
+public:
+    /**
+     * @throws std::invalid_argument if divisor is zero
+     */
+    explicit Divisor(BigNumView divisor);
+
+    BigNumView value() const { return _value; }
+    std::size_t size() const { return _value._digits.size(); }
+
+    /**
+     * @return Divisor times 2^shift()
+     */
+    BigNumView normalized() const { return _normalized; }
+    unsigned shift() const { return _shift; }
+
+    /**
+     * @return Inverse of the top limb of normalized divisor by mpn::invert_limb
+     */
+    Limb inverse() const { return _inverse; }
+
+private:
+    BigNum _value;
+    BigNum _normalized;
+    unsigned _shift;
+    Limb _inverse;
+};
+
+/**
+ * @brief Sizes in limbs from which multiplication and division switch to faster methods.
+ *        Active ones, returned by current(), start from the sizes compiled from Thresholds.hpp,
+ *        which `tune` target measures on current machine, and can be overridden by environment variables
+ *        LAB_MIN_FOR_KARATSUBA, LAB_MIN_FOR_TOOM3, LAB_MIN_FOR_NTT, LAB_MIN_FOR_PARALLEL,
+ *        LAB_MIN_FOR_DIVISION and LAB_MIN_FOR_NEWTON
+ * @note Every field defaults to max(), which turns its method off, so Thresholds{} multiplies
+ *       and divides naively only and brace initialization turns the omitted tiers off.
+ *       Changing some of the active thresholds starts from a copy of current()
+ */
+struct Thresholds
+{
+    static constexpr std::size_t OFF = std::numeric_limits<std::size_t>::max();
+
+    std::size_t karatsuba = OFF; ///< operands up to this size are multiplied naively
+    std::size_t toom3 = OFF;     ///< operands from this size are split into three parts
+    std::size_t ntt = OFF;       ///< operands from this size are multiplied by number-theoretic transform
+    std::size_t parallel = OFF;  ///< operands from this size are split into products running in parallel
+    std::size_t division = OFF;  ///< divisors and quotients from this size are divided recursively
+    std::size_t newton = OFF;    ///< divisors and quotients from this size are divided by Newton's reciprocal
+
+    static const Thresholds& current();
+
+    /**
+     * @note Too small thresholds are raised to ones every method can work with.
+     *       Must not be called while other threads multiply
+     */
+    static void set(const Thresholds& thresholds);
+};
+
+/**
+ * @brief Class for holding positive integers of at most Bits bits.
+ *        Number of limbs is known at compile time, so it never allocates
+ *        and all of the loops are unrolled
+ * @note Addition and subtraction wrap around modulo 2^Bits
+ */
+template <std::size_t Bits>
+class FixedNum
+{
+public:
+    static_assert(Bits > 0, "FixedNum must hold at least one bit");
+
+    ///< Number of limbs in representation
+    static constexpr std::size_t LIMBS = (Bits + 63) / 64;
+
+    constexpr FixedNum() = default;
+
+    constexpr explicit FixedNum(Limb value) {
+        _limbs[0] = value;
+        _limbs[LIMBS - 1] &= TOP_MASK;
+    }
+
+    /**
+     * @throws std::invalid_argument if num does not fit in Bits bits
+     */
+    explicit FixedNum(const BigNum& num) {
+        const auto& digits = num._digits;
+        if (digits.size() > LIMBS || (digits.size() == LIMBS && (digits.back() & ~TOP_MASK) != 0))
+            throw std::invalid_argument("Number does not fit in FixedNum.");
+        std::copy(digits.begin(), digits.end(), _limbs.begin());
+    }
+
+    explicit operator BigNum() const {
+        BigNum result;
+        result._digits.assign(_limbs.begin(), _limbs.end());
+        while (!result._digits.empty() && result._digits.back() == 0) {
+            result._digits.pop_back();
+        }
+        return result;
+    }
+
+    constexpr const Limb& operator[](std::size_t n) const {
+        return _limbs[n];
+    }
+
+    friend constexpr FixedNum operator+(const FixedNum& left, const FixedNum& right) {
+        FixedNum result;
+        _add(result._limbs.data(), left._limbs.data(), right._limbs.data(), INDICES);
+        result._limbs[LIMBS - 1] &= TOP_MASK;
+        return result;
+    }
+
+    friend constexpr FixedNum operator-(const FixedNum& left, const FixedNum& right) {
+        FixedNum result;
+        _subtract(result._limbs.data(), left._limbs.data(), right._limbs.data(), INDICES);
+        result._limbs[LIMBS - 1] &= TOP_MASK;
+        return result;
+    }
+
+    /**
+     * @return Full product, which never overflows
+     */
+    friend constexpr FixedNum<Bits * 2> operator*(const FixedNum& left, const FixedNum& right) {
+        std::array<Limb, LIMBS * 2> product{};
+        _multiply(product.data(), left._limbs.data(), right._limbs.data(), INDICES);
+        FixedNum<Bits * 2> result;
+        for (std::size_t i = 0; i < FixedNum<Bits * 2>::LIMBS; ++i) {
+            result._limbs[i] = product[i];
+        }
+        return result;
+    }
+
+    friend constexpr bool operator<(const FixedNum& left, const FixedNum& right) {
+        return _compare(left._limbs.data(), right._limbs.data(), INDICES) < 0;
+    }
+    friend constexpr bool operator>(const FixedNum& left, const FixedNum& right) {
+        return right < left;
+    }
+    friend constexpr bool operator<=(const FixedNum& left, const FixedNum& right) {
+        return !(right < left);
+    }
+    friend constexpr bool operator>=(const FixedNum& left, const FixedNum& right) {
+        return !(left < right);
+    }
+    friend constexpr bool operator==(const FixedNum& left, const FixedNum& right) {
+        return _compare(left._limbs.data(), right._limbs.data(), INDICES) == 0;
+    }
+    friend constexpr bool operator!=(const FixedNum& left, const FixedNum& right) {
+        return !(left == right);
+    }
+
+private:
+    template <std::size_t>
+    friend class FixedNum;
+
+    using DoubleLimb = unsigned __int128;
+
+    ///< Bits of the most significant limb which belong to the number
+    static constexpr Limb TOP_MASK = Bits % 64 == 0 ? ~Limb(0) : (Limb(1) << (Bits % 64)) - 1;
+
+    static constexpr auto INDICES = std::make_index_sequence<LIMBS>{};
+
+    template <std::size_t... I>
+    static constexpr void _add(Limb* result, const Limb* left, const Limb* right,
+                               std::index_sequence<I...>) {
+        Limb carry = 0;
+        ((result[I] = _addCarry(left[I], right[I], carry)), ...);
+    }
+
+    template <std::size_t... I>
+    static constexpr void _subtract(Limb* result, const Limb* left, const Limb* right,
+                                    std::index_sequence<I...>) {
+        Limb borrow = 0;
+        ((result[I] = _subtractBorrow(left[I], right[I], borrow)), ...);
+    }
+
+    template <std::size_t... I>
+    static constexpr void _multiply(Limb* result, const Limb* left, const Limb* right,
+                                    std::index_sequence<I...>) {
+        (_multiplyRow<I>(result, left[I], right, INDICES), ...);
+    }
+
+    /**
+     * @brief Adds right multiplied by single limb to result shifted by I limbs
+     */
+    template <std::size_t I, std::size_t... J>
+    static constexpr void _multiplyRow(Limb* result, Limb left, const Limb* right,
+                                       std::index_sequence<J...>) {
+        Limb carry = 0;
+        ((result[I + J] = _multiplyAdd(left, right[J], result[I + J], carry)), ...);
+        result[I + LIMBS] = carry;
+    }
+
+    /**
+     * @return -1, 0 or 1 if left is less, equal or bigger than right
+     */
+    template <std::size_t... I>
+    static constexpr int _compare(const Limb* left, const Limb* right, std::index_sequence<I...>) {
+        int result = 0;
+        ((result = result != 0 ? result
+                 : left[LIMBS - 1 - I] < right[LIMBS - 1 - I] ? -1
+                 : left[LIMBS - 1 - I] > right[LIMBS - 1 - I] ? 1 : 0), ...);
+        return result;
+    }
+
+    static constexpr Limb _addCarry(Limb left, Limb right, Limb& carry) {
+        const DoubleLimb temp = static_cast<DoubleLimb>(left) + right + carry;
+        carry = static_cast<Limb>(temp >> 64);
+        return static_cast<Limb>(temp);
+    }
+
+    static constexpr Limb _subtractBorrow(Limb left, Limb right, Limb& borrow) {
+        const DoubleLimb temp = static_cast<DoubleLimb>(left) - right - borrow;
+        borrow = static_cast<Limb>(temp >> 64) & 1;
+        return static_cast<Limb>(temp);
+    }
+
+    static constexpr Limb _multiplyAdd(Limb left, Limb right, Limb addend, Limb& carry) {
+        const DoubleLimb temp = static_cast<DoubleLimb>(left) * right + addend + carry;
+        carry = static_cast<Limb>(temp >> 64);
+        return static_cast<Limb>(temp);
+    }
+
+    ///< Array of coefficients in basis 2^64, least significant first
+    std::array<Limb, LIMBS> _limbs{};
 };
 
 template<typename OStream>
 OStream& operator<<(OStream& os, const BigNum& num)
 {
-    for (auto it = num._digits.rbegin(); it != num._digits.rend(); ++it) {
-        std::string s(std::to_string(*it));
-        while (s.size() != 9 && it != num._digits.rbegin())
-            s.insert(0, "0");
-        os << s;
-    }
+    os << to_string(num);
     return os;
 }
 
@@ -0,0 +1,233 @@
+#pragma once
+
+#include <BigNum.hpp>
+
+namespace lab {
+
+/**
+ * @brief Lazy arithmetic on BigNum. Expression is only captured by operators
+ *        and gets evaluated when converted to BigNum, every step writes to one
+ *        destination. Under % the modulus is prepared as Divisor once for the whole
+ *        expression and every step is reduced by it, a product is still computed
+ *        in full and then divided, as there is no fused kernel for arbitrary moduli
+ * @note Expressions keep references to their operands, so these must outlive them
+ */
+namespace expr {
+
+template <typename E>
+class Expression
+{
+public:
+    const E& self() const {
+        return static_cast<const E&>(*this);
+    }
+
+    operator BigNum() const {
+        BigNum result;
+        self().evaluateTo(result);
+        return result;
+    }
+};
+
+/**
+ * @brief Leaf of expression, refers to existing number without copying it
+ */
+class Operand : public Expression<Operand>
+{
+public:
+    explicit Operand(const BigNum& num) : _num(num) {}
+
+    const BigNum& value() const {
+        return _num;
+    }
+
+    void evaluateTo(BigNum& dest) const {
+        dest = _num;
+    }
+
+    void evaluateModuloTo(BigNum& dest, const Divisor& mod) const {
+        dest = _num;
+        modify(dest, mod);
+    }
+
+private:
+    const BigNum& _num;
+};
+
+/**
+ * @return Value of expression, operands are returned as they are and
+ *         anything else is evaluated to storage
+ */
+template <typename E>
+const BigNum& valueOf(const Expression<E>& expression, BigNum& storage) {
+    expression.self().evaluateTo(storage);
+    return storage;
+}
+
+inline const BigNum& valueOf(const Expression<Operand>& expression, BigNum&) {
+    return expression.self().value();
+}
+
+/**
+ * @return Value of expression in group modulo mod, operands are returned as
+ *         they are since modulo kernels reduce them themselves
+ */
+template <typename E>
+const BigNum& valueModuloOf(const Expression<E>& expression, BigNum& storage, const Divisor& mod) {
+    expression.self().evaluateModuloTo(storage, mod);
+    return storage;
+}
+
+inline const BigNum& valueModuloOf(const Expression<Operand>& expression, BigNum&, const Divisor&) {
+    return expression.self().value();
+}
+
+struct Plus
+{
+    static void apply(BigNum& dest, const BigNum& value) {
+        dest += value;
+    }
+
+    static void applyModulo(BigNum& dest, const BigNum& value, const Divisor& mod) {
+        modifyAdd(dest, value, mod);
+    }
+};
+
+/**
+ * @note Without modulo left side must be bigger than right one,
+ *       under modulo the difference is taken in group modulo mod
+ */
+struct Minus
+{
+    static void apply(BigNum& dest, const BigNum& value) {
+        dest -= value;
+    }
+
+    static void applyModulo(BigNum& dest, const BigNum& value, const Divisor& mod) {
+        modifySubtract(dest, value, mod);
+    }
+};
+
+struct Multiplies
+{
+    static void apply(BigNum& dest, const BigNum& value) {
+        dest *= value;
+    }
+
+    static void applyModulo(BigNum& dest, const BigNum& value, const Divisor& mod) {
+        modifyMultiply(dest, value, mod);
+    }
+};
+
+template <typename L, typename R, typename Op>
+class Binary : public Expression<Binary<L, R, Op>>
+{
+public:
+    Binary(const L& left, const R& right) : _left(left), _right(right) {}
+
+    void evaluateTo(BigNum& dest) const {
+        _left.evaluateTo(dest);
+        BigNum storage;
+        Op::apply(dest, valueOf(_right, storage));
+    }
+
+    void evaluateModuloTo(BigNum& dest, const Divisor& mod) const {
+        _left.evaluateModuloTo(dest, mod);
+        BigNum storage;
+        Op::applyModulo(dest, valueModuloOf(_right, storage, mod), mod);
+    }
+
+private:
+    L _left;
+    R _right;
+};
+
+template <typename E>
+class Remainder : public Expression<Remainder<E>>
+{
+public:
+    Remainder(const E& expression, const BigNum& mod) : _expression(expression), _mod(mod) {}
+
+    void evaluateTo(BigNum& dest) const {
+        _expression.evaluateModuloTo(dest, Divisor(_mod));
+    }
+
+    void evaluateModuloTo(BigNum& dest, const Divisor& mod) const {
+        evaluateTo(dest);
+        modify(dest, mod);
+    }
+
+private:
+    E _expression;
+    const BigNum& _mod;
+};
+
+template <typename L, typename R>
+Binary<L, R, Plus> operator+(const Expression<L>& left, const Expression<R>& right) {
+    return Binary<L, R, Plus>(left.self(), right.self());
+}
+
+template <typename L>
+Binary<L, Operand, Plus> operator+(const Expression<L>& left, const BigNum& right) {
+    return Binary<L, Operand, Plus>(left.self(), Operand(right));
+}
+
+template <typename R>
+Binary<Operand, R, Plus> operator+(const BigNum& left, const Expression<R>& right) {
+    return Binary<Operand, R, Plus>(Operand(left), right.self());
+}
+
+template <typename L, typename R>
+Binary<L, R, Minus> operator-(const Expression<L>& left, const Expression<R>& right) {
+    return Binary<L, R, Minus>(left.self(), right.self());
+}
+
+template <typename L>
+Binary<L, Operand, Minus> operator-(const Expression<L>& left, const BigNum& right) {
+    return Binary<L, Operand, Minus>(left.self(), Operand(right));
+}
+
+template <typename R>
+Binary<Operand, R, Minus> operator-(const BigNum& left, const Expression<R>& right) {
+    return Binary<Operand, R, Minus>(Operand(left), right.self());
+}
+
+template <typename L, typename R>
+Binary<L, R, Multiplies> operator*(const Expression<L>& left, const Expression<R>& right) {
+    return Binary<L, R, Multiplies>(left.self(), right.self());
+}
+
+template <typename L>
+Binary<L, Operand, Multiplies> operator*(const Expression<L>& left, const BigNum& right) {
+    return Binary<L, Operand, Multiplies>(left.self(), Operand(right));
+}
+
+template <typename R>
+Binary<Operand, R, Multiplies> operator*(const BigNum& left, const Expression<R>& right) {
+    return Binary<Operand, R, Multiplies>(Operand(left), right.self());
+}
+
+template <typename E>
+Remainder<E> operator%(const Expression<E>& expression, const BigNum& mod) {
+    return Remainder<E>(expression.self(), mod);
+}
+
+/**
+ * @brief Evaluates expression to dest reusing its buffer
+ * @note dest must not be an operand of expression other than the leftmost one
+ */
+template <typename E>
+void evaluate(BigNum& dest, const Expression<E>& expression) {
+    expression.self().evaluateTo(dest);
+}
+
+} // namespace expr
+
+/**
+ * @brief Starts lazy expression, e.g. BigNum r = (lazy(a) * b) % mod
+ */
+inline expr::Operand lazy(const BigNum& num) {
+    return expr::Operand(num);
+}
+
+} // namespace lab
@@ -0,0 +1,213 @@
+#include <LimbKernels.hpp>
+#include <Limbs.hpp>
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <cpuid.h>
+#define LAB_HAS_ADX_KERNELS 1
+#endif
+
+namespace lab {
+
+namespace kernels {
+
+namespace {
+
+/**
+ * @brief Product is computed column by column (Comba's method): every column sums its
+ *        products to a wide accumulator and carries to the next column only once
+ */
+void portableBasecaseMultiplication(const Limb* lhs, std::size_t lhs_size,
+                                    const Limb* rhs, std::size_t rhs_size, Limb* result) {
+    mpn::ColumnSum sum;
+    mpn::mul_columns(lhs, lhs_size, rhs, rhs_size, 0, lhs_size + rhs_size - 1, sum, result);
+    result[lhs_size + rhs_size - 1] = sum.next();
+}
+
+/**
+ * @brief Reduction is a row of multiply-accumulate per limb, so every variant
+ *        differs only in the row it uses
+ */
+template<Limb (*AddMul)(Limb*, const Limb*, std::size_t, Limb)>
+void montgomeryReduceBy(Limb* num, const Limb* mod, std::size_t size, Limb inverse) {
+    for (std::size_t i = 0; i < size; ++i) {
+        // makes the lowest limb zero, and then it keeps the carry to size limbs above it
+        num[i] = AddMul(num + i, mod, size, num[i] * inverse);
+    }
+    Limb* result = num + size;
+    // the sum is less than mod * 2, so one subtraction is enough
+    const bool exceeds = mpn::add_n(result, result, num, size) != 0;
+    if (exceeds || mpn::cmp(result, mod, size) >= 0) {
+        mpn::sub_n(result, result, mod, size);
+    }
+}
+
+#ifdef LAB_HAS_ADX_KERNELS
+bool hasAdx() {
+    unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+        return false;
+    }
+    constexpr unsigned BMI2 = 1u << 8;
+    constexpr unsigned ADX = 1u << 19;
+    return (ebx & BMI2) != 0 && (ebx & ADX) != 0;
+}
+
+#define LAB_ADX_STEP(offset)                                          \
+    "mulxq " #offset "(%[num], %[i], 8), %[low], %[high]\n\t"         \
+    "adcxq %[carry], %[low]\n\t"                                      \
+    "adoxq " #offset "(%[result], %[i], 8), %[low]\n\t"               \
+    "movq %[low], " #offset "(%[result], %[i], 8)\n\t"                \
+    "movq %[high], %[carry]\n\t"
+
+/**
+ * @brief Multiply-accumulate where the high limbs of products are added by ADCX
+ *        and the limbs of result by ADOX, so the two carry chains do not wait for each other
+ */
+Limb adxAddMul(Limb* result, const Limb* num, std::size_t size, Limb factor) {
+    // the unrolled loop takes four limbs at once, the rest goes first
+    const std::size_t head = size % 4;
+    Limb carry = mpn::addmul_1(result, num, head, factor);
+    if (head == size) {
+        return carry;
+    }
+
+    Limb low;
+    Limb high;
+    Limb zero;
+    // index runs from minus size to zero, JRCXZ ends the loop without touching the flags
+    auto i = -static_cast<std::ptrdiff_t>(size - head);
+    __asm__ volatile(
+        "xorl %k[zero], %k[zero]\n\t"
+        "1:\n\t"
+        LAB_ADX_STEP(0) LAB_ADX_STEP(8) LAB_ADX_STEP(16) LAB_ADX_STEP(24)
+        "leaq 4(%[i]), %[i]\n\t"
+        "jrcxz 2f\n\t"
+        "jmp 1b\n\t"
+        "2:\n\t"
+        "adcxq %[zero], %[carry]\n\t"
+        "adoxq %[zero], %[carry]"
+        : [carry] "+&r"(carry), [low] "=&r"(low), [high] "=&r"(high), [zero] "=&r"(zero), [i] "+c"(i)
+        : [num] "r"(num + size), [result] "r"(result + size), "d"(factor)
+        : "cc", "memory");
+    return carry;
+}
+
+#undef LAB_ADX_STEP
+
+/**
+ * @brief Product is accumulated row by row, each row is a multiply-accumulate with two carry chains
+ */
+void adxBasecaseMultiplication(const Limb* lhs, std::size_t lhs_size,
+                               const Limb* rhs, std::size_t rhs_size, Limb* result) {
+    // the longer operand makes the rows
+    if (lhs_size < rhs_size) {
+        std::swap(lhs, rhs);
+        std::swap(lhs_size, rhs_size);
+    }
+    result[lhs_size] = mpn::mul_1(result, lhs, lhs_size, rhs[0]);
+    for (std::size_t i = 1; i < rhs_size; ++i) {
+        result[lhs_size + i] = adxAddMul(result + i, lhs, lhs_size, rhs[i]);
+    }
+}
+#endif
+
+struct KernelTable
+{
+    Variant variant;
+    Limb (*addmul_1)(Limb*, const Limb*, std::size_t, Limb);
+    void (*basecaseMultiplication)(const Limb*, std::size_t, const Limb*, std::size_t, Limb*);
+    void (*montgomeryReduce)(Limb*, const Limb*, std::size_t, Limb);
+};
+
+constexpr KernelTable PORTABLE_KERNELS = {
+    Variant::Portable,
+    mpn::addmul_1,
+    portableBasecaseMultiplication,
+    montgomeryReduceBy<mpn::addmul_1>
+};
+
+#ifdef LAB_HAS_ADX_KERNELS
+constexpr KernelTable ADX_KERNELS = {
+    Variant::Adx,
+    adxAddMul,
+    adxBasecaseMultiplication,
+    montgomeryReduceBy<adxAddMul>
+};
+#endif
+
+const KernelTable& tableOf(Variant variant) {
+#ifdef LAB_HAS_ADX_KERNELS
+    if (variant == Variant::Adx) {
+        return ADX_KERNELS;
+    }
+#endif
+    return PORTABLE_KERNELS;
+}
+
+std::atomic<const KernelTable*>& activeTable() {
+    static std::atomic<const KernelTable*> table = [] {
+        const char* forced = std::getenv("LAB_LIMB_KERNELS");
+        if (forced != nullptr && std::strcmp(forced, "portable") == 0) {
+            return &PORTABLE_KERNELS;
+        }
+        return isSupported(Variant::Adx) ? &tableOf(Variant::Adx) : &PORTABLE_KERNELS;
+    }();
+    return table;
+}
+
+inline const KernelTable& kernels() {
+    return *activeTable().load(std::memory_order_relaxed);
+}
+}
+
+bool isSupported(Variant variant) {
+    switch (variant) {
+    case Variant::Portable:
+        return true;
+    case Variant::Adx:
+#ifdef LAB_HAS_ADX_KERNELS
+        static const bool supported = hasAdx();
+        return supported;
+#else
+        return false;
+#endif
+    }
+    return false;
+}
+
+Variant current() {
+    return kernels().variant;
+}
+
+void select(Variant variant) {
+    if (!isSupported(variant)) {
+        throw std::invalid_argument("Processor does not support these kernels.");
+    }
+    activeTable().store(&tableOf(variant), std::memory_order_relaxed);
+}
+
+Limb addmul_1(Limb* result, const Limb* num, std::size_t size, Limb factor) {
+    return kernels().addmul_1(result, num, size, factor);
+}
+
+void basecaseMultiplication(const Limb* lhs, std::size_t lhs_size,
+                            const Limb* rhs, std::size_t rhs_size, Limb* result) {
+    if (lhs_size == 0 || rhs_size == 0) {
+        std::fill(result, result + lhs_size + rhs_size, 0);
+        return;
+    }
+    kernels().basecaseMultiplication(lhs, lhs_size, rhs, rhs_size, result);
+}
+
+void montgomeryReduce(Limb* num, const Limb* mod, std::size_t size, Limb inverse) {
+    kernels().montgomeryReduce(num, mod, size, inverse);
+}
+
+} // namespace kernels
+
+} // namespace lab
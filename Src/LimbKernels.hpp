@@ -0,0 +1,53 @@
+#pragma once
+
+#include <LimbVector.hpp>
+
+namespace lab {
+
+/**
+ * @brief Innermost multiplication loops in variants for different processors.
+ *        The best variant the processor supports is chosen at startup, unless
+ *        environment variable LAB_LIMB_KERNELS is "portable". Every variant gives the same results
+ */
+namespace kernels {
+
+enum class Variant {
+    Portable, ///< plain C++ for any processor
+    Adx       ///< x86-64 with BMI2 and ADX, multiply-accumulate runs two carry chains by ADCX and ADOX
+};
+
+bool isSupported(Variant variant);
+
+Variant current();
+
+/**
+ * @brief Makes given variant current for the whole process, e.g. to compare variants
+ * @throws std::invalid_argument if processor does not support it
+ */
+void select(Variant variant);
+
+/**
+ * @brief Adds num * factor to result
+ * @return Limb going out of result
+ * @note Result must not overlap num
+ */
+Limb addmul_1(Limb* result, const Limb* num, std::size_t size, Limb factor);
+
+/**
+ * @brief Writes product of lhs and rhs to result, which must hold lhs_size + rhs_size limbs
+ * @note Result must not overlap operands
+ */
+void basecaseMultiplication(const Limb* lhs, std::size_t lhs_size,
+                            const Limb* rhs, std::size_t rhs_size, Limb* result);
+
+/**
+ * @brief Montgomery's reduction, replaces num of size * 2 limbs with num / 2^(64 * size) modulo mod
+ *        in its upper size limbs. The lower ones are destroyed
+ * @param inverse -mod^(-1) modulo 2^64
+ * @note Mod must be odd and num less than mod * 2^(64 * size), then the result is less than mod
+ */
+void montgomeryReduce(Limb* num, const Limb* mod, std::size_t size, Limb inverse);
+
+} // namespace kernels
+
+} // namespace lab
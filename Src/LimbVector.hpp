@@ -0,0 +1,238 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <iterator>
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
+
+namespace lab {
+
+/**
+ * @brief Single cell of BigNum's binary representation, numbers are stored in basis 2^64
+ */
+using Limb = std::uint64_t;
+
+/**
+ * @brief Selects memory resource for limbs allocated by current thread while the object lives,
+ *        e.g. monotonic arena for temporaries which is then released in one shot
+ * @note Numbers created in the scope keep using its resource after it ends,
+ *       so the resource must outlive them
+ */
+class LimbResourceScope
+{
+public:
+    explicit LimbResourceScope(std::pmr::memory_resource* resource)
+        : _previous(_current) {
+        _current = resource;
+    }
+
+    ~LimbResourceScope() {
+        _current = _previous;
+    }
+
+    LimbResourceScope(const LimbResourceScope&) = delete;
+    LimbResourceScope& operator=(const LimbResourceScope&) = delete;
+
+    /**
+     * @return Resource for limbs allocated by current thread
+     */
+    static std::pmr::memory_resource* current() {
+        return _current != nullptr ? _current : std::pmr::get_default_resource();
+    }
+
+private:
+    static inline thread_local std::pmr::memory_resource* _current = nullptr;
+
+    std::pmr::memory_resource* _previous;
+};
+
+/**
+ * @brief Vector of limbs which keeps up to N of them inside the object
+ *        and goes to the heap only when it grows bigger.
+ *        Heap buffer is taken from memory resource selected at construction
+ */
+template <std::size_t N>
+class LimbVector
+{
+public:
+    using value_type = Limb;
+    using size_type = std::size_t;
+    using iterator = Limb*;
+    using const_iterator = const Limb*;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    LimbVector() = default;
+
+    explicit LimbVector(std::pmr::memory_resource* resource)
+        : _resource(resource) {
+    }
+
+    explicit LimbVector(size_type count, Limb value = 0) {
+        resize(count, value);
+    }
+
+    template <typename Iter, typename = std::enable_if_t<!std::is_integral_v<Iter>>>
+    LimbVector(Iter first, Iter last) {
+        assign(first, last);
+    }
+
+    LimbVector(const LimbVector& that) {
+        assign(that.begin(), that.end());
+    }
+
+    LimbVector(LimbVector&& that) noexcept
+        : _resource(that._resource) {
+        _steal(that);
+    }
+
+    ~LimbVector() {
+        _release();
+    }
+
+    LimbVector& operator=(const LimbVector& that) {
+        if (this != &that) {
+            assign(that.begin(), that.end());
+        }
+        return *this;
+    }
+
+    /**
+     * @note Heap buffer from another memory resource is copied rather than taken
+     */
+    LimbVector& operator=(LimbVector&& that) {
+        if (this == &that) {
+            return *this;
+        }
+        if (that.isInline() || *that._resource == *_resource) {
+            _release();
+            _steal(that);
+        } else {
+            assign(that.begin(), that.end());
+        }
+        return *this;
+    }
+
+    template <typename Iter>
+    void assign(Iter first, Iter last) {
+        const auto count = static_cast<size_type>(std::distance(first, last));
+        _size = 0;
+        reserve(count);
+        std::copy(first, last, _data);
+        _size = count;
+    }
+
+    size_type size() const { return _size; }
+    size_type capacity() const { return _capacity; }
+    bool empty() const { return _size == 0; }
+
+    /**
+     * @return Whether elements are stored inside the object
+     */
+    bool isInline() const { return _data == _inline; }
+
+    std::pmr::memory_resource* resource() const { return _resource; }
+
+    Limb* data() { return _data; }
+    const Limb* data() const { return _data; }
+
+    iterator begin() { return _data; }
+    iterator end() { return _data + _size; }
+    const_iterator begin() const { return _data; }
+    const_iterator end() const { return _data + _size; }
+
+    reverse_iterator rbegin() { return reverse_iterator(end()); }
+    reverse_iterator rend() { return reverse_iterator(begin()); }
+    const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+    Limb& operator[](size_type n) { return _data[n]; }
+    const Limb& operator[](size_type n) const { return _data[n]; }
+
+    Limb& back() { return _data[_size - 1]; }
+    const Limb& back() const { return _data[_size - 1]; }
+
+    void push_back(Limb value) {
+        if (_size == _capacity) {
+            _grow(_size + 1);
+        }
+        _data[_size++] = value;
+    }
+
+    void pop_back() { --_size; }
+
+    void clear() { _size = 0; }
+
+    void reserve(size_type count) {
+        if (count > _capacity) {
+            _grow(count);
+        }
+    }
+
+    void resize(size_type count, Limb value = 0) {
+        reserve(count);
+        if (count > _size) {
+            std::fill(_data + _size, _data + count, value);
+        }
+        _size = count;
+    }
+
+    friend bool operator==(const LimbVector& left, const LimbVector& right) {
+        return std::equal(left.begin(), left.end(), right.begin(), right.end());
+    }
+
+    friend bool operator!=(const LimbVector& left, const LimbVector& right) {
+        return !(left == right);
+    }
+
+private:
+    /**
+     * @brief Moves elements to the heap buffer big enough for at least count limbs
+     */
+    void _grow(size_type count) {
+        const size_type new_capacity = std::max(count, _capacity * 2);
+        Limb* new_data = static_cast<Limb*>(_resource->allocate(new_capacity * sizeof(Limb), alignof(Limb)));
+        std::copy(_data, _data + _size, new_data);
+        _release();
+        _data = new_data;
+        _capacity = new_capacity;
+    }
+
+    void _release() {
+        if (!isInline()) {
+            _resource->deallocate(_data, _capacity * sizeof(Limb), alignof(Limb));
+        }
+        _data = _inline;
+        _capacity = N;
+    }
+
+    /**
+     * @brief Takes heap buffer of that or copies its inline elements, leaves that empty
+     * @note Heap buffer must come from the same memory resource
+     */
+    void _steal(LimbVector& that) {
+        if (that.isInline()) {
+            std::copy(that._data, that._data + that._size, _inline);
+            _data = _inline;
+            _capacity = N;
+        } else {
+            _data = that._data;
+            _capacity = that._capacity;
+            that._data = that._inline;
+            that._capacity = N;
+        }
+        _size = that._size;
+        that._size = 0;
+    }
+
+    std::pmr::memory_resource* _resource = LimbResourceScope::current();
+    Limb* _data = _inline;
+    size_type _size = 0;
+    size_type _capacity = N;
+    Limb _inline[N];
+};
+
+} // namespace lab
@@ -0,0 +1,401 @@
+#pragma once
+
+#include <LimbVector.hpp>
+
+#include <algorithm>
+
+namespace lab {
+
+/**
+ * @brief Primitives on raw spans of limbs, least significant first, in the spirit of GMP's mpn layer.
+ *        Every primitive returns the limb going out of the span instead of growing it, so the caller
+ *        decides where the carry goes. Result may be the same span as an operand unless noted otherwise
+ */
+namespace mpn {
+
+/**
+ * @brief Double-width cell for products of limbs
+ */
+using DoubleLimb = unsigned __int128;
+
+constexpr int LIMB_BITS = 64;
+
+/**
+ * @brief Writes lhs + rhs of given size to result
+ * @return Carry, 0 or 1
+ */
+inline Limb add_n(Limb* result, const Limb* lhs, const Limb* rhs, std::size_t size) {
+#if defined(__x86_64__) && defined(__GNUC__)
+    // compilers do not keep carry flag between iterations, so the chain is written with adc
+    if (size == 0) {
+        return 0;
+    }
+    Limb carry;
+    Limb temp;
+    std::size_t i = 0;
+    __asm__ volatile(
+        "xorl %k[carry], %k[carry]\n\t"
+        "1:\n\t"
+        "movq (%[lhs], %[i], 8), %[temp]\n\t"
+        "adcq (%[rhs], %[i], 8), %[temp]\n\t"
+        "movq %[temp], (%[result], %[i], 8)\n\t"
+        "leaq 1(%[i]), %[i]\n\t"
+        "decq %[size]\n\t"
+        "jnz 1b\n\t"
+        "setc %b[carry]"
+        : [carry] "=&r"(carry), [temp] "=&r"(temp), [i] "+r"(i), [size] "+r"(size)
+        : [result] "r"(result), [lhs] "r"(lhs), [rhs] "r"(rhs)
+        : "cc", "memory");
+    return carry;
+#else
+    Limb carry = 0;
+    for (std::size_t i = 0; i < size; ++i) {
+        const Limb sum = lhs[i] + rhs[i] + carry;
+        carry = (sum < lhs[i]) || (sum == lhs[i] && carry != 0);
+        result[i] = sum;
+    }
+    return carry;
+#endif
+}
+
+/**
+ * @brief Writes lhs - rhs of given size to result
+ * @return Borrow, 0 or 1
+ */
+inline Limb sub_n(Limb* result, const Limb* lhs, const Limb* rhs, std::size_t size) {
+#if defined(__x86_64__) && defined(__GNUC__)
+    if (size == 0) {
+        return 0;
+    }
+    Limb borrow;
+    Limb temp;
+    std::size_t i = 0;
+    __asm__ volatile(
+        "xorl %k[borrow], %k[borrow]\n\t"
+        "1:\n\t"
+        "movq (%[lhs], %[i], 8), %[temp]\n\t"
+        "sbbq (%[rhs], %[i], 8), %[temp]\n\t"
+        "movq %[temp], (%[result], %[i], 8)\n\t"
+        "leaq 1(%[i]), %[i]\n\t"
+        "decq %[size]\n\t"
+        "jnz 1b\n\t"
+        "setc %b[borrow]"
+        : [borrow] "=&r"(borrow), [temp] "=&r"(temp), [i] "+r"(i), [size] "+r"(size)
+        : [result] "r"(result), [lhs] "r"(lhs), [rhs] "r"(rhs)
+        : "cc", "memory");
+    return borrow;
+#else
+    Limb borrow = 0;
+    for (std::size_t i = 0; i < size; ++i) {
+        const Limb left = lhs[i];
+        const Limb right = rhs[i];
+        result[i] = left - right - borrow;
+        borrow = (left < right) || (left == right && borrow != 0);
+    }
+    return borrow;
+#endif
+}
+
+/**
+ * @brief Compares lhs and rhs of given size from the top limb
+ * @return Negative, zero or positive as lhs is less than, equal to or greater than rhs
+ */
+inline int cmp(const Limb* lhs, const Limb* rhs, std::size_t size) {
+    for (std::size_t i = size; i-- > 0;) {
+        if (lhs[i] != rhs[i]) {
+            return lhs[i] < rhs[i] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Writes num + value to result, carry stops as soon as it is absorbed,
+ *        then the rest of num is copied unless result is num itself
+ * @return Carry, 0 or 1
+ */
+inline Limb add_1(Limb* result, const Limb* num, std::size_t size, Limb value) {
+    std::size_t i = 0;
+    for (; value != 0 && i < size; ++i) {
+        result[i] = num[i] + value;
+        value = result[i] < value;
+    }
+    if (result != num) {
+        std::copy(num + i, num + size, result + i);
+    }
+    return value;
+}
+
+/**
+ * @brief Writes num - value to result, borrow stops as soon as it is absorbed,
+ *        then the rest of num is copied unless result is num itself
+ * @return Borrow, 0 or 1
+ */
+inline Limb sub_1(Limb* result, const Limb* num, std::size_t size, Limb value) {
+    std::size_t i = 0;
+    for (; value != 0 && i < size; ++i) {
+        const Limb limb = num[i];
+        result[i] = limb - value;
+        value = limb < value;
+    }
+    if (result != num) {
+        std::copy(num + i, num + size, result + i);
+    }
+    return value;
+}
+
+/**
+ * @brief Writes num * factor to result
+ * @return High limb of the product
+ */
+inline Limb mul_1(Limb* result, const Limb* num, std::size_t size, Limb factor) {
+    Limb carry = 0;
+    for (std::size_t i = 0; i < size; ++i) {
+        const DoubleLimb temp = static_cast<DoubleLimb>(num[i]) * factor + carry;
+        result[i] = static_cast<Limb>(temp);
+        carry = static_cast<Limb>(temp >> LIMB_BITS);
+    }
+    return carry;
+}
+
+/**
+ * @brief Adds num * factor to result
+ * @return Limb going out of result
+ * @note Result must not overlap num
+ */
+inline Limb addmul_1(Limb* result, const Limb* num, std::size_t size, Limb factor) {
+    Limb carry = 0;
+    for (std::size_t i = 0; i < size; ++i) {
+        // fits: (2^64 - 1)^2 + 2 * (2^64 - 1) < 2^128
+        const DoubleLimb temp = static_cast<DoubleLimb>(num[i]) * factor + result[i] + carry;
+        result[i] = static_cast<Limb>(temp);
+        carry = static_cast<Limb>(temp >> LIMB_BITS);
+    }
+    return carry;
+}
+
+/**
+ * @brief Subtracts num * factor from result
+ * @return Limb borrowed from above result
+ * @note Result must not overlap num
+ */
+inline Limb submul_1(Limb* result, const Limb* num, std::size_t size, Limb factor) {
+    Limb borrow = 0;
+    for (std::size_t i = 0; i < size; ++i) {
+        const DoubleLimb product = static_cast<DoubleLimb>(num[i]) * factor + borrow;
+        const Limb low = static_cast<Limb>(product);
+        borrow = static_cast<Limb>(product >> LIMB_BITS) + (result[i] < low);
+        result[i] -= low;
+    }
+    return borrow;
+}
+
+/**
+ * @brief Sum of a column of product in Comba's method: the column sums its products
+ *        to three limbs and carries to the next column only once
+ */
+struct ColumnSum {
+    DoubleLimb low = 0;
+    Limb top = 0;
+
+    void add(DoubleLimb value) {
+        low += value;
+        top += low < value;
+    }
+
+    /**
+     * @brief Adds lhs[i] * rhs[column - i] for i from first below end
+     */
+    void addProducts(const Limb* lhs, const Limb* rhs, std::size_t column, std::size_t first, std::size_t end) {
+        for (std::size_t i = first; i < end; ++i) {
+            add(static_cast<DoubleLimb>(lhs[i]) * rhs[column - i]);
+        }
+    }
+
+    void doubled() {
+        top = (top << 1) | static_cast<Limb>(low >> (2 * LIMB_BITS - 1));
+        low <<= 1;
+    }
+
+    /**
+     * @return The lowest limb of the column, the rest becomes the carry to the next one
+     */
+    Limb next() {
+        const auto limb = static_cast<Limb>(low);
+        low = (static_cast<DoubleLimb>(top) << LIMB_BITS) | static_cast<Limb>(low >> LIMB_BITS);
+        top = 0;
+        return limb;
+    }
+};
+
+/**
+ * @brief Writes columns from begin below end of product of lhs and rhs to result by Comba's method,
+ *        the first one goes to result[0]
+ * @param sum carry to the first column, gets the carry out of the last one
+ * @note Result must not overlap operands
+ */
+inline void mul_columns(const Limb* lhs, std::size_t lhs_size, const Limb* rhs, std::size_t rhs_size,
+                        std::size_t begin, std::size_t end, ColumnSum& sum, Limb* result) {
+    for (std::size_t column = begin; column < end; ++column) {
+        const std::size_t first = column < rhs_size ? 0 : column - rhs_size + 1;
+        sum.addProducts(lhs, rhs, column, first, std::min(column + 1, lhs_size));
+        result[column - begin] = sum.next();
+    }
+}
+
+/**
+ * @brief Writes num shifted left by given number of bits to result
+ * @param shift number of bits from [1, 63]
+ * @return Bits shifted out of the top limb, in the low bits
+ * @note Num must not be empty, result may overlap it only from above, e.g. be num itself
+ */
+inline Limb lshift(Limb* result, const Limb* num, std::size_t size, unsigned shift) {
+    const Limb out = num[size - 1] >> (LIMB_BITS - shift);
+    for (std::size_t i = size - 1; i > 0; --i) {
+        result[i] = (num[i] << shift) | (num[i - 1] >> (LIMB_BITS - shift));
+    }
+    result[0] = num[0] << shift;
+    return out;
+}
+
+/**
+ * @brief Writes num shifted right by given number of bits to result
+ * @param shift number of bits from [1, 63]
+ * @return Bits shifted out of the bottom limb, in the high bits
+ * @note Num must not be empty, result may overlap it only from below, e.g. be num itself
+ */
+inline Limb rshift(Limb* result, const Limb* num, std::size_t size, unsigned shift) {
+    const Limb out = num[0] << (LIMB_BITS - shift);
+    for (std::size_t i = 0; i + 1 < size; ++i) {
+        result[i] = (num[i] >> shift) | (num[i + 1] << (LIMB_BITS - shift));
+    }
+    result[size - 1] = num[size - 1] >> shift;
+    return out;
+}
+
+/**
+ * @brief Inverse of divisor by Moller and Granlund, (2^128 - 1) / divisor - 2^64,
+ *        which turns division by divisor into multiplication
+ * @note Top bit of divisor must be set
+ */
+inline Limb invert_limb(Limb divisor) {
+    // the quotient is from [2^64, 2^65), so its low limb is the inverse
+    return static_cast<Limb>(~static_cast<DoubleLimb>(0) / divisor);
+}
+
+/**
+ * @brief Inverse of num modulo 2^64 by Newton's iteration, num is its own inverse modulo 2^3
+ *        and every step doubles the number of correct bits
+ * @note Num must be odd
+ */
+inline Limb binvert_limb(Limb num) {
+    Limb inverse = num;
+    for (int i = 0; i < 5; ++i) {
+        inverse *= 2 - num * inverse;
+    }
+    return inverse;
+}
+
+/**
+ * @brief Divides high * 2^64 + low by divisor with its inverse from invert_limb,
+ *        Algorithm 4 of Moller and Granlund's "Improved division by invariant integers"
+ * @return Quotient, the remainder goes to rest
+ * @note Top bit of divisor must be set and high must be less than divisor
+ */
+inline Limb divrem_2by1(Limb high, Limb low, Limb divisor, Limb inverse, Limb& rest) {
+    DoubleLimb estimate = static_cast<DoubleLimb>(inverse) * high;
+    estimate += (static_cast<DoubleLimb>(high) << LIMB_BITS) | low;
+    auto quotient = static_cast<Limb>(estimate >> LIMB_BITS) + 1;
+    Limb remainder = low - quotient * divisor;
+    // the estimate is one too big about half of the time, which is corrected without branch,
+    // and rarely one too small
+    const Limb mask = 0 - static_cast<Limb>(remainder > static_cast<Limb>(estimate));
+    quotient += mask;
+    remainder += mask & divisor;
+    if (__builtin_expect(remainder >= divisor, 0)) {
+        ++quotient;
+        remainder -= divisor;
+    }
+    rest = remainder;
+    return quotient;
+}
+
+/**
+ * @brief Writes num / divisor to quotient for divisor prepared by the caller
+ * @param normalized divisor shifted left by shift bits so that its top bit is set
+ * @param inverse invert_limb(normalized)
+ * @return Remainder
+ * @note Quotient may be num itself
+ */
+inline Limb divrem_1_preinv(Limb* quotient, const Limb* num, std::size_t size,
+                            Limb normalized, unsigned shift, Limb inverse) {
+    if (size == 0) {
+        return 0;
+    }
+    if (shift == 0) {
+        Limb rest = 0;
+        for (std::size_t i = size; i-- > 0;) {
+            quotient[i] = divrem_2by1(rest, num[i], normalized, inverse, rest);
+        }
+        return rest;
+    }
+
+    // num is shifted as well on the fly, the bits shifted out of its top limb begin the remainder
+    Limb rest = num[size - 1] >> (LIMB_BITS - shift);
+    for (std::size_t i = size; i-- > 0;) {
+        const Limb low = (num[i] << shift) | (i > 0 ? num[i - 1] >> (LIMB_BITS - shift) : 0);
+        quotient[i] = divrem_2by1(rest, low, normalized, inverse, rest);
+    }
+    return rest >> shift;
+}
+
+/**
+ * @brief Writes num / divisor to quotient, every limb costs two multiplications instead of division
+ * @return Remainder
+ * @note Divisor must not be zero, quotient may be num itself
+ */
+inline Limb divrem_1(Limb* quotient, const Limb* num, std::size_t size, Limb divisor) {
+    const auto shift = static_cast<unsigned>(__builtin_clzll(divisor));
+    divisor <<= shift;
+    return divrem_1_preinv(quotient, num, size, divisor, shift, invert_limb(divisor));
+}
+
+/**
+ * @brief Remainder of num by divisor prepared by the caller like for divrem_1_preinv,
+ *        which does not store quotient
+ */
+inline Limb mod_1_preinv(const Limb* num, std::size_t size, Limb normalized, unsigned shift, Limb inverse) {
+    if (size == 0) {
+        return 0;
+    }
+    // quotients of divrem_2by1 are dropped
+    if (shift == 0) {
+        // top limb is less than twice the divisor, so it is reduced by a subtraction
+        Limb rest = num[size - 1] >= normalized ? num[size - 1] - normalized : num[size - 1];
+        for (std::size_t i = size - 1; i-- > 0;) {
+            divrem_2by1(rest, num[i], normalized, inverse, rest);
+        }
+        return rest;
+    }
+
+    Limb rest = num[size - 1] >> (LIMB_BITS - shift);
+    for (std::size_t i = size; i-- > 0;) {
+        const Limb low = (num[i] << shift) | (i > 0 ? num[i - 1] >> (LIMB_BITS - shift) : 0);
+        divrem_2by1(rest, low, normalized, inverse, rest);
+    }
+    return rest >> shift;
+}
+
+/**
+ * @return Remainder of num by divisor
+ * @note Divisor must not be zero
+ */
+inline Limb mod_1(const Limb* num, std::size_t size, Limb divisor) {
+    const auto shift = static_cast<unsigned>(__builtin_clzll(divisor));
+    divisor <<= shift;
+    return mod_1_preinv(num, size, divisor, shift, invert_limb(divisor));
+}
+
+} // namespace mpn
+
+} // namespace lab
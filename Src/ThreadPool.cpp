@@ -0,0 +1,148 @@
+#include <ThreadPool.hpp>
+
+#include <algorithm>
+#include <exception>
+
+namespace lab {
+
+namespace {
+/**
+ * @brief Pool whose worker is the current thread, if any, and index of its queue
+ */
+thread_local const ThreadPool* current_pool = nullptr;
+thread_local std::size_t current_queue = 0;
+}
+
+ThreadPool::ThreadPool(std::size_t workers) {
+    for (std::size_t i = 0; i <= workers; ++i) {
+        _queues.push_back(std::make_unique<Queue>());
+    }
+    for (std::size_t i = 0; i < workers; ++i) {
+        _threads.emplace_back([this, i] { _work(i); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    _stopping = true;
+    {
+        std::lock_guard<std::mutex> lock(_sleep_mutex);
+    }
+    _wake.notify_all();
+    for (auto& thread : _threads) {
+        thread.join();
+    }
+}
+
+ThreadPool& ThreadPool::shared() {
+    static ThreadPool pool(std::max(std::thread::hardware_concurrency(), 2u) - 1);
+    return pool;
+}
+
+std::size_t ThreadPool::workers() const {
+    return _threads.size();
+}
+
+void ThreadPool::forkJoin(std::vector<Task> tasks) {
+    if (tasks.empty()) {
+        return;
+    }
+
+    std::atomic<std::size_t> remaining(tasks.size() - 1);
+    std::exception_ptr error;
+    std::mutex error_mutex;
+    const auto record_error = [&error, &error_mutex] {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if (!error) {
+            error = std::current_exception();
+        }
+    };
+
+    const auto queue = _ownQueue();
+    for (std::size_t i = 1; i < tasks.size(); ++i) {
+        _push(queue, [&remaining, &record_error, task = std::move(tasks[i])] {
+            try {
+                task();
+            } catch (...) {
+                record_error();
+            }
+            remaining.fetch_sub(1, std::memory_order_acq_rel);
+        });
+    }
+
+    try {
+        tasks.front()();
+    } catch (...) {
+        record_error();
+    }
+
+    while (remaining.load(std::memory_order_acquire) != 0) {
+        if (!_runOne(queue)) {
+            std::this_thread::yield();
+        }
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+std::size_t ThreadPool::_ownQueue() const {
+    return current_pool == this ? current_queue : _queues.size() - 1;
+}
+
+void ThreadPool::_push(std::size_t queue, Task task) {
+    {
+        std::lock_guard<std::mutex> lock(_queues[queue]->mutex);
+        _queues[queue]->tasks.push_back(std::move(task));
+    }
+    _pending.fetch_add(1, std::memory_order_release);
+    // taking the lock orders the push before the check of a worker going to sleep
+    {
+        std::lock_guard<std::mutex> lock(_sleep_mutex);
+    }
+    _wake.notify_one();
+}
+
+bool ThreadPool::_runOne(std::size_t queue) {
+    if (_pending.load(std::memory_order_acquire) == 0) {
+        return false;
+    }
+
+    Task task;
+    {
+        Queue& own = *_queues[queue];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+        }
+    }
+    for (std::size_t i = 1; !task && i < _queues.size(); ++i) {
+        Queue& other = *_queues[(queue + i) % _queues.size()];
+        std::lock_guard<std::mutex> lock(other.mutex);
+        if (!other.tasks.empty()) {
+            task = std::move(other.tasks.front());
+            other.tasks.pop_front();
+        }
+    }
+    if (!task) {
+        return false;
+    }
+
+    _pending.fetch_sub(1, std::memory_order_acq_rel);
+    task();
+    return true;
+}
+
+void ThreadPool::_work(std::size_t queue) {
+    current_pool = this;
+    current_queue = queue;
+    while (!_stopping) {
+        if (!_runOne(queue)) {
+            std::unique_lock<std::mutex> lock(_sleep_mutex);
+            _wake.wait(lock, [this] { return _pending.load() > 0 || _stopping; });
+        }
+    }
+}
+
+} // namespace lab
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace lab {
+
+/**
+ * @brief Work-stealing pool of threads for fork-join parallelism.
+ *        Every worker keeps its own queue, takes the newest task from it
+ *        and steals the oldest ones from the others when it runs dry
+ */
+class ThreadPool
+{
+public:
+    using Task = std::function<void()>;
+
+    explicit ThreadPool(std::size_t workers);
+
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @return Pool shared by the whole process, which has a worker for every core
+     *         except the calling one, but at least one
+     */
+    static ThreadPool& shared();
+
+    std::size_t workers() const;
+
+    /**
+     * @brief Runs tasks, possibly in parallel, and returns when all of them are finished.
+     *        Calling thread runs the first task itself and then helps with any queued ones,
+     *        so tasks may fork their own tasks without deadlock
+     * @note The first exception thrown by tasks is rethrown after all of them finish
+     */
+    void forkJoin(std::vector<Task> tasks);
+
+private:
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    /**
+     * @return Queue of current thread if it is a worker of this pool,
+     *         otherwise queue shared by other threads
+     */
+    std::size_t _ownQueue() const;
+
+    void _push(std::size_t queue, Task task);
+
+    /**
+     * @brief Runs the newest task of queue or the oldest task of any other queue
+     * @return Whether there was a task to run
+     */
+    bool _runOne(std::size_t queue);
+
+    void _work(std::size_t queue);
+
+    ///< Queues of workers followed by one for other threads
+    std::vector<std::unique_ptr<Queue>> _queues;
+    std::vector<std::thread> _threads;
+
+    std::atomic<std::size_t> _pending{0};
+    std::atomic<bool> _stopping{false};
+    std::mutex _sleep_mutex;
+    std::condition_variable _wake;
+};
+
+} // namespace lab
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <memory_resource>
+
+namespace test {
+    /**
+     * @brief Resource which counts allocations made through it
+     */
+    class CountingResource : public std::pmr::memory_resource {
+    public:
+        int allocations = 0;
+
+    private:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+            ++allocations;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+            std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+    };
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <BigNum.hpp>
+
+#include <random>
+#include <vector>
+
+namespace test {
+    /**
+     * @brief Random limbs, about every ones_period-th of them is all ones, which carries the most
+     *        through arithmetic. Zero ones_period makes all of them random
+     */
+    inline std::vector<lab::Limb> randomLimbs(std::mt19937_64& generator, std::size_t size,
+                                              unsigned ones_period = 4) {
+        std::vector<lab::Limb> limbs(size);
+        for (auto& limb : limbs) {
+            limb = ones_period != 0 && generator() % ones_period == 0 ? ~lab::Limb(0) : generator();
+        }
+        return limbs;
+    }
+
+    inline lab::BigNum toNum(const std::vector<lab::Limb>& limbs) {
+        return lab::BigNum(lab::BigNumView(limbs.data(), limbs.size()));
+    }
+
+    /**
+     * @return Random number of exactly size limbs, its top limb is never zero
+     */
+    inline lab::BigNum randomNum(std::mt19937_64& generator, std::size_t size, unsigned ones_period = 4) {
+        auto limbs = randomLimbs(generator, size, ones_period);
+        if (!limbs.empty()) {
+            limbs.back() |= 1;
+        }
+        return toNum(limbs);
+    }
+}
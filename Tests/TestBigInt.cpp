@@ -0,0 +1,56 @@
+#include <BigInt.hpp>
+
+#include <sstream>
+
+#include "catch.hpp"
+
+TEST_CASE("Big signed integers test", "[BigInt]") {
+    const lab::BigInt a("-340282366920938463463374607431768211455");
+    const lab::BigInt b(18446744073709551617_bn);
+
+    SECTION( "BigInt from/to string" ) {
+        REQUIRE(to_string(a) == "-340282366920938463463374607431768211455");
+        REQUIRE(to_string(b) == "18446744073709551617");
+        REQUIRE(to_string(lab::BigInt("-0")) == "0");
+        std::stringstream out;
+        out << a;
+        REQUIRE(out.str() == to_string(a));
+    }
+
+    SECTION( "Compare" ) {
+        REQUIRE(a < b);
+        REQUIRE(-b < b);
+        REQUIRE(a < -b);
+        REQUIRE(b > lab::BigInt());
+        REQUIRE(lab::BigInt("-0") == lab::BigInt());
+        REQUIRE(a != -a);
+    }
+
+    SECTION( "Arithmetic" ) {
+        REQUIRE(a + b == lab::BigInt("-340282366920938463444927863358058659838"));
+        REQUIRE(b + a == lab::BigInt("-340282366920938463444927863358058659838"));
+        REQUIRE(a - b == lab::BigInt("-340282366920938463481821351505477763072"));
+        REQUIRE(b - a == lab::BigInt("340282366920938463481821351505477763072"));
+        REQUIRE(a * b == lab::BigInt("-6277101735386680764176071790128604879547283307822093172735"));
+        REQUIRE(a * -b == -(a * b));
+        REQUIRE(a - a == lab::BigInt());
+
+        auto num = a;
+        num += -a;
+        REQUIRE(num == lab::BigInt());
+        num -= b;
+        REQUIRE(num == -b);
+        num *= a;
+        REQUIRE(num == -(a * b));
+    }
+
+    SECTION( "Division" ) {
+        const lab::BigInt mod(1000000007_bn);
+        REQUIRE(a / mod == lab::BigInt("-340282364538961911690641225597"));
+        REQUIRE(a % mod == lab::BigInt("-279632276"));
+        REQUIRE((a / mod) * mod + a % mod == a);
+        REQUIRE(residue(a, 97_bn) == 63_bn);
+        REQUIRE(residue(-a, 97_bn) == 34_bn);
+        REQUIRE(residue(lab::BigInt(), 97_bn) == 0_bn);
+    }
+}
@@ -1,8 +1,13 @@
 #include <BigNum.hpp>
 
 #include <sstream>
+#include <memory_resource>
+#include <random>
 
 #include "catch.hpp"
+#include "CountingResource.hpp"
+#include "RandomLimbs.hpp"
+#include "ThresholdsGuard.hpp"
 
 TEST_CASE("Big numbers test", "[BigNum]") {
     SECTION( "Streaming a BigNum" ) {
@@ -173,6 +178,36 @@ TEST_CASE("Big numbers test", "[BigNum]") {
         }
     }
 
+    SECTION( "Move" ) {
+        const auto a = 340282366920938463463374607431768211455_bn;
+        const auto b = 18446744073709551617_bn;
+        const auto sum = 340282366920938463481821351505477763072_bn;
+
+        SECTION( "construct and assign" ) {
+            lab::BigNum tmp = a;
+            lab::BigNum moved = std::move(tmp);
+            REQUIRE(moved == a);
+            tmp = std::move(moved);
+            REQUIRE(tmp == a);
+        }
+        SECTION( "add" ) {
+            REQUIRE(lab::BigNum(a) + b == sum);
+            REQUIRE(a + lab::BigNum(b) == sum);
+            REQUIRE(lab::BigNum(a) + lab::BigNum(b) == sum);
+            REQUIRE(a + b + a + b == sum + sum);
+        }
+        SECTION( "subtract" ) {
+            REQUIRE(lab::BigNum(sum) - b == a);
+            REQUIRE(sum - lab::BigNum(b) == a);
+            REQUIRE(sum - lab::BigNum(a) == b);
+            REQUIRE(lab::BigNum(sum) - lab::BigNum(a) == b);
+            REQUIRE(sum - a - b == 0_bn);
+        }
+        SECTION( "multiply by int" ) {
+            REQUIRE(lab::BigNum(a) * 2 == a + a);
+        }
+    }
+
     SECTION( "Multiply" ) {
         SECTION( "test" ) {
             const lab::BigNum a("7752362423526235624");
@@ -223,6 +258,141 @@ TEST_CASE("Big numbers test", "[BigNum]") {
             REQUIRE(extract(num1, num2).first == lab::BigNum("400006"));
             REQUIRE(extract(num1, num2).second == lab::BigNum("0"));
         }
+        SECTION( "limbs" ) {
+            // top limbs of divisor make the estimate of quotient limb too big and it is corrected
+            const lab::Limb divisor_limbs[] = {18446744073709551615ull, 0, 9223372036854775808ull};
+            const lab::BigNum divisor(lab::BigNumView(divisor_limbs, 3));
+            std::mt19937_64 generator(11);
+            for (std::size_t size = 1; size <= 40; size += 3) {
+                const auto quotient = test::toNum(test::randomLimbs(generator, size, 3));
+                for (const auto& remainder : {0_bn, 1_bn, divisor - 1_bn}) {
+                    const auto num = quotient * divisor + remainder;
+                    REQUIRE(extract(num, divisor).first == quotient);
+                    REQUIRE(extract(num, divisor).second == remainder);
+                    REQUIRE(num % quotient == remainder % quotient);
+                }
+            }
+        }
+        SECTION( "recursive" ) {
+            std::mt19937_64 generator(22);
+
+            const test::ThresholdsGuard guard;
+            // the smallest threshold makes every division recursive down to a couple of limbs
+            for (const std::size_t division : {std::size_t(2), std::size_t(5), guard.saved().division}) {
+                auto thresholds = guard.saved();
+                thresholds.division = division;
+                lab::Thresholds::set(thresholds);
+                for (const std::size_t divisor_size : {1, 2, 3, 7, 16, 33, 80}) {
+                    for (const std::size_t quotient_size : {1, 4, 15, 33, 80, 170}) {
+                        // every second limb is all ones in the second round
+                        for (const unsigned ones_period : {0, 2}) {
+                            const auto divisor = test::randomNum(generator, divisor_size, ones_period);
+                            const auto quotient = test::randomNum(generator, quotient_size, ones_period);
+                            const auto remainder = test::randomNum(generator, divisor_size, ones_period) % divisor;
+                            const auto result = extract(quotient * divisor + remainder, divisor);
+                            REQUIRE(result.first == quotient);
+                            REQUIRE(result.second == remainder);
+                        }
+                    }
+                }
+            }
+        }
+        SECTION( "reciprocal" ) {
+            std::mt19937_64 generator(23);
+            const auto power = [](std::size_t exponent) {
+                std::vector<lab::Limb> limbs(exponent + 1);
+                limbs.back() = 1;
+                return lab::BigNum(lab::BigNumView(limbs.data(), limbs.size()));
+            };
+
+            const test::ThresholdsGuard guard;
+            // the smallest threshold makes even short divisions go by reciprocal
+            for (const std::size_t newton : {std::size_t(8), std::size_t(11), guard.saved().newton}) {
+                auto thresholds = guard.saved();
+                thresholds.division = 5;
+                thresholds.newton = newton;
+                lab::Thresholds::set(thresholds);
+                for (const std::size_t divisor_size : {1, 2, 9, 30, 75}) {
+                    const auto divisor = test::randomNum(generator, divisor_size);
+                    for (const std::size_t precision : {0, 1, 6, 9, 40, 90, 200}) {
+                        const auto inverse = reciprocal(divisor, precision);
+                        REQUIRE(inverse * divisor <= power(precision));
+                        REQUIRE(power(precision) - inverse * divisor < divisor);
+                    }
+                    for (const std::size_t quotient_size : {1, 8, 30, 120}) {
+                        const auto quotient = test::randomNum(generator, quotient_size);
+                        for (const auto& remainder : {0_bn, divisor - 1_bn}) {
+                            const auto result = extract(quotient * divisor + remainder, divisor);
+                            REQUIRE(result.first == quotient);
+                            REQUIRE(result.second == remainder);
+                        }
+                    }
+                }
+            }
+            REQUIRE(reciprocal(3_bn, 1) == 6148914691236517205_bn);
+            REQUIRE_THROWS_AS(reciprocal(0_bn, 1), std::invalid_argument);
+        }
+        SECTION( "single limb" ) {
+            std::mt19937_64 generator(24);
+            for (const lab::Limb divisor : {1ull, 2ull, 3ull, 10000000000000000000ull, 9223372036854775808ull,
+                                            18446744073709551615ull, 6700417ull}) {
+                const lab::BigNum divisor_num(lab::BigNumView(&divisor, 1));
+                for (std::size_t size = 0; size <= 20; size += 4) {
+                    const auto num = test::toNum(test::randomLimbs(generator, size, 3));
+                    const auto [quotient, remainder] = divmod_1(num, divisor);
+                    REQUIRE(remainder < divisor);
+                    REQUIRE(quotient * divisor_num + lab::BigNum(lab::BigNumView(&remainder, 1)) == num);
+                    REQUIRE(extract(num, divisor_num).first == quotient);
+                    REQUIRE(num % divisor_num == lab::BigNum(lab::BigNumView(&remainder, 1)));
+                }
+            }
+            REQUIRE(divmod_1(123456789012345678901234567890_bn, 1000000007).second == 197434842);
+            REQUIRE_THROWS_AS(divmod_1(num1, 0), std::invalid_argument);
+        }
+        SECTION( "prepared divisor" ) {
+            std::mt19937_64 generator(25);
+            for (const std::size_t divisor_size : {1, 2, 5, 60}) {
+                // top limbs of every bit length make every shift of normalization
+                auto limbs = test::randomLimbs(generator, divisor_size);
+                limbs.back() = (limbs.back() >> (generator() % 64)) | 1;
+                const auto modulus = test::toNum(limbs);
+                const lab::Divisor divisor(modulus);
+                REQUIRE(divisor.value() == modulus);
+                REQUIRE(divisor.normalized()[divisor_size - 1] >> 63 == 1);
+
+                lab::BigNum num = modulus * modulus * 12345_bn + 678_bn;
+                REQUIRE(extract(num, divisor) == extract(num, modulus));
+                REQUIRE(num % divisor == num % modulus);
+                REQUIRE(extract(678_bn, divisor).second == 678_bn % modulus);
+                modify(num, divisor);
+                REQUIRE(num == (modulus * modulus * 12345_bn + 678_bn) % modulus);
+
+                const lab::BigNum other = modulus * 98765_bn + 4321_bn;
+                for (const auto& start : {0_bn, num, modulus * 3_bn + 1_bn}) {
+                    lab::BigNum prepared = start;
+                    lab::BigNum plain = start;
+                    modifyAdd(prepared, other, divisor);
+                    modifyAdd(plain, other, modulus);
+                    REQUIRE(prepared == plain);
+                    modifySubtract(prepared, other, divisor);
+                    modifySubtract(plain, other, modulus);
+                    REQUIRE(prepared == plain);
+                    modifyMultiply(prepared, other, divisor);
+                    modifyMultiply(plain, other, modulus);
+                    REQUIRE(prepared == plain);
+                    REQUIRE(prepared == start * other % modulus);
+                }
+            }
+            // divisor of a temporary keeps its own copy of it
+            const lab::Divisor temporary(1000000007_bn * 1000000009_bn);
+            REQUIRE(temporary.value() == 1000000016000000063_bn);
+            REQUIRE(2000000032000000127_bn % temporary == 1_bn);
+            REQUIRE_THROWS_AS(lab::Divisor(0_bn), std::invalid_argument);
+        }
+        SECTION( "by zero" ) {
+            REQUIRE_THROWS_AS(extract(num1, 0_bn), std::invalid_argument);
+            REQUIRE(extract(0_bn, num1).first == 0_bn);
+        }
     }
 
     SECTION("Multiplication") {
@@ -238,6 +408,237 @@ TEST_CASE("Big numbers test", "[BigNum]") {
             const auto b = 9999101010101000010130929493583285892397887897238874399999_bn;
             REQUIRE(a * b == 999901336365994481304641755778280969957261726037535427297722733918150118427240475620078108944452582380001_bn);
         }
+
+        SECTION("Karatsuba") {
+            const lab::BigNum a(std::string(700, '9'));
+            const std::string expect = std::string(699, '9') + "8" + std::string(699, '0') + "1";
+            REQUIRE(to_string(a * a) == expect);
+
+            std::string pattern;
+            for (int i = 0; i < 150; ++i) {
+                pattern += "123456789";
+            }
+            const lab::BigNum x(pattern);
+            REQUIRE((x + 1_bn) * (x - 1_bn) == x * x - 1_bn);
+        }
+
+        SECTION("Karatsuba allocates only result") {
+            const lab::BigNum a(std::string(700, '9'));
+            const auto warm_up = a * a;
+            test::CountingResource counting;
+            lab::LimbResourceScope scope(&counting);
+            const auto product = a * a;
+            REQUIRE(counting.allocations == 1);
+            REQUIRE(product == warm_up);
+        }
+
+        SECTION("Modulo product of curve size does not allocate") {
+            // modulus of secp256k1
+            const auto p = 115792089237316195423570985008687907853269984665640564039457584007908834671663_bn;
+            const auto a = p - 1234567_bn;
+            const auto b = p - 89101112_bn;
+            const auto expected = 1234567_bn * 89101112_bn;
+            test::CountingResource counting;
+            lab::LimbResourceScope scope(&counting);
+            const auto product = multiply(a, b, p);
+            const auto remainder = a * b % p;
+            const auto prepared = a * b % lab::Divisor(p);
+            REQUIRE(counting.allocations == 0);
+            REQUIRE(product == expected);
+            REQUIRE(remainder == expected);
+            REQUIRE(prepared == expected);
+        }
+
+        SECTION("Basecase") {
+            // powers of 2^64 for every length the basecase handles
+            std::vector<lab::BigNum> powers{1_bn};
+            for (int i = 0; i < 64; ++i) {
+                powers.push_back(powers.back() * 18446744073709551616_bn);
+            }
+            for (std::size_t a = 1; a <= 32; ++a) {
+                for (std::size_t b = 1; b <= 32; ++b) {
+                    // all limbs are ones, so every column of the product carries the most
+                    const auto lhs = powers[a] - 1_bn;
+                    const auto rhs = powers[b] - 1_bn;
+                    REQUIRE(lhs * rhs == powers[a + b] + 1_bn - powers[a] - powers[b]);
+                }
+                const auto ones = powers[a] - 1_bn;
+                REQUIRE(square(ones) == powers[2 * a] + 1_bn - powers[a] - powers[a]);
+            }
+        }
+
+        SECTION("Toom-3") {
+            for (const std::size_t digits : {2500, 9000, 19300}) {
+                const lab::BigNum a(std::string(digits, '9'));
+                const std::string expect = std::string(digits - 1, '9') + "8" + std::string(digits - 1, '0') + "1";
+                REQUIRE(to_string(a * a) == expect);
+            }
+
+            std::string pattern;
+            for (int i = 0; i < 1000; ++i) {
+                pattern += "987654321";
+            }
+            const lab::BigNum x(pattern);
+            const lab::BigNum y(pattern.substr(0, 5000) + "1");
+            REQUIRE((x + 1_bn) * (x - 1_bn) == x * x - 1_bn);
+            REQUIRE(x * (y + 1_bn) == x * y + x);
+            REQUIRE((x * y) * y == x * (y * y));
+        }
+
+        SECTION("Number-theoretic transform") {
+            // powers of 2^64 below the threshold are built by Toom-Cook method
+            auto q = 18446744073709551616_bn;
+            for (int i = 0; i < 13; ++i) {
+                q = q * q;
+            }
+            const auto p = q * q;
+            const auto p2 = p * q * q;
+
+            // all limbs of x are ones, which makes coefficients of convolution the largest
+            const auto x = p - 1_bn;
+            const auto y = p - q;
+            REQUIRE(x * x == p2 - p - p + 1_bn);
+            REQUIRE(x * y == p2 - p * q - p + q);
+        }
+
+        SECTION("Unbalanced") {
+            const auto powerOfTen = [](std::size_t degree) {
+                return lab::BigNum("1" + std::string(degree, '0'));
+            };
+            const std::pair<std::size_t, std::size_t> sizes[] = {
+                {19000, 80}, {19000, 800}, {19000, 3000}, {5000, 3100}, {1300, 700}, {700, 1300}
+            };
+            for (const auto& [a, b] : sizes) {
+                const lab::BigNum lhs(std::string(a, '9'));
+                const lab::BigNum rhs(std::string(b, '9'));
+                // (10^a - 1) * (10^b - 1) = 10^(a + b) - 10^a - 10^b + 1
+                const auto expect = powerOfTen(a + b) + 1_bn - powerOfTen(a) - powerOfTen(b);
+                REQUIRE(lhs * rhs == expect);
+            }
+        }
+
+        SECTION("Thresholds") {
+            std::string pattern;
+            for (int i = 0; i < 300; ++i) {
+                pattern += "2718281828459045";
+            }
+            std::vector<lab::BigNum> nums;
+            std::vector<lab::BigNum> products;
+            for (const std::size_t digits : {30, 200, 900, 1700, 4800}) {
+                nums.emplace_back(pattern.substr(0, digits));
+            }
+            for (const auto& lhs : nums) {
+                for (const auto& rhs : nums) {
+                    products.push_back(lhs * rhs);
+                }
+            }
+
+            const test::ThresholdsGuard guard;
+            {
+                const test::ThresholdsGuard inner;
+                lab::Thresholds::set({});
+            }
+            REQUIRE(lab::Thresholds::current().karatsuba == guard.saved().karatsuba);
+
+            // every method splits even short operands now
+            auto thresholds = guard.saved();
+            thresholds.karatsuba = 0;
+            thresholds.toom3 = 0;
+            thresholds.ntt = 0;
+            thresholds.division = 0;
+            thresholds.newton = 0;
+            lab::Thresholds::set(thresholds);
+            REQUIRE(lab::Thresholds::current().karatsuba == 4);
+            REQUIRE(lab::Thresholds::current().toom3 == 16);
+            REQUIRE(lab::Thresholds::current().ntt == 64);
+            REQUIRE(lab::Thresholds::current().division == 2);
+            REQUIRE(lab::Thresholds::current().newton == 8);
+
+            std::size_t i = 0;
+            for (const auto& lhs : nums) {
+                for (const auto& rhs : nums) {
+                    REQUIRE(lhs * rhs == products[i++]);
+                }
+            }
+
+            // and every level of recursion runs its products in parallel
+            thresholds.parallel = 0;
+            lab::Thresholds::set(thresholds);
+            i = 0;
+            for (const auto& lhs : nums) {
+                for (const auto& rhs : nums) {
+                    REQUIRE(lhs * rhs == products[i++]);
+                }
+            }
+            // omitted fields turn their methods off, which leaves naive multiplication only
+            REQUIRE(lab::Thresholds{32}.toom3 == lab::Thresholds::OFF);
+            lab::Thresholds::set({});
+            i = 0;
+            for (const auto& lhs : nums) {
+                for (const auto& rhs : nums) {
+                    REQUIRE(lhs * rhs == products[i++]);
+                }
+            }
+            std::vector<lab::Limb> limbs(21);
+            limbs.back() = 1;
+            const lab::BigNum power(lab::BigNumView(limbs.data(), limbs.size()));
+            REQUIRE(mulhi(nums[3], nums[4], 20) * power + mullo(nums[3], nums[4], 20) == products[19]);
+        }
+
+        SECTION("Short products") {
+            std::mt19937_64 generator(19);
+            const auto randomNum = [&generator](std::size_t size) { return test::randomNum(generator, size, 0); };
+            std::vector<lab::BigNum> powers{1_bn};
+            for (int i = 0; i < 400; ++i) {
+                powers.push_back(powers.back() * 18446744073709551616_bn);
+            }
+            const auto check = [&powers](const lab::BigNum& lhs, const lab::BigNum& rhs, std::size_t size) {
+                const auto low = mullo(lhs, rhs, size);
+                const auto high = mulhi(lhs, rhs, size);
+                REQUIRE(low < powers[size]);
+                REQUIRE(high * powers[size] + low == lhs * rhs);
+            };
+
+            const test::ThresholdsGuard guard;
+            // the smallest thresholds make parts of short products split too
+            for (const std::size_t karatsuba : {guard.saved().karatsuba, std::size_t(4)}) {
+                auto thresholds = guard.saved();
+                thresholds.karatsuba = karatsuba;
+                lab::Thresholds::set(thresholds);
+                for (const std::size_t size : {1, 2, 3, 9, 40, 65, 130, 200}) {
+                    check(randomNum(size), randomNum(size), size);
+                    // all ones carry the most from the lower limbs to the upper ones
+                    const auto ones = powers[size] - 1_bn;
+                    check(ones, ones, size);
+                    check(ones, randomNum(size), size);
+                    // operands shorter or longer than size
+                    check(randomNum(size / 2 + 1), randomNum(size), size);
+                    check(randomNum(size * 2), randomNum(size), size);
+                }
+            }
+
+            REQUIRE(mullo(0_bn, 5_bn, 3) == 0_bn);
+            REQUIRE(mulhi(7_bn, 5_bn, 1) == 0_bn);
+            REQUIRE(mullo(7_bn, 5_bn, 0) == 0_bn);
+            REQUIRE(mulhi(7_bn, 5_bn, 0) == 35_bn);
+        }
+
+        SECTION("Squaring") {
+            std::string pattern;
+            for (int i = 0; i < 3000; ++i) {
+                pattern += "5318008";
+            }
+            for (const std::size_t digits : {1, 20, 100, 700, 1300, 4000, 21000}) {
+                const lab::BigNum x(pattern.substr(0, digits));
+                const lab::BigNum copy = x;
+                REQUIRE(square(x) == x * copy);
+
+                const lab::BigNum nines(std::string(digits, '9'));
+                const lab::BigNum nines_copy = nines;
+                REQUIRE(nines * nines == nines * nines_copy);
+            }
+            REQUIRE(square(0_bn) == 0_bn);
+        }
     }
 
     SECTION("Modulo multiplication") {
@@ -247,6 +648,43 @@ TEST_CASE("Big numbers test", "[BigNum]") {
         REQUIRE(multiply(a, b, mod) == 88191807529973443_bn);
     }
 
+    SECTION("Compound assignment") {
+        auto num = 18446744073709551615_bn;
+
+        SECTION("arithmetic") {
+            num += 1_bn;
+            REQUIRE(num == 18446744073709551616_bn);
+            num -= 18446744073709551615_bn;
+            REQUIRE(num == 1_bn);
+            num *= 340282366920938463463374607431768211455_bn;
+            REQUIRE(num == 340282366920938463463374607431768211455_bn);
+            num *= 3;
+            REQUIRE(num == 1020847100762815390390123822295304634365_bn);
+            num %= 1000000007_bn;
+            REQUIRE(num == 1020847100762815390390123822295304634365_bn % 1000000007_bn);
+        }
+        SECTION("modulo") {
+            const auto mod = 666666666666_bn;
+            auto a = 12345678907777456243534_bn;
+            modifyAdd(a, 12345600077741235700399_bn, mod);
+            REQUIRE(a == 210049889585_bn);
+
+            auto b = 12345678907777456243534_bn;
+            modifySubtract(b, 1234560007774123570039999_bn, mod);
+            REQUIRE(b == 431671874667_bn);
+
+            auto c = 4241229841928441249124921409124091221_bn;
+            modifyMultiply(c, 12901092091309210942109410951309019490_bn, 120130924091094109_bn);
+            REQUIRE(c == 88191807529973443_bn);
+
+            auto d = 123456789_bn;
+            modifyMultiply(d, d, 1000000007_bn);
+            REQUIRE(d == 643499475_bn);
+            modifySubtract(d, d, 1000000007_bn);
+            REQUIRE(d == 0_bn);
+        }
+    }
+
     SECTION("Inverse number") {
 
         {
@@ -261,4 +699,108 @@ TEST_CASE("Big numbers test", "[BigNum]") {
             REQUIRE(inverted(a, mod, lab::BigNum::InversionPolicy::Fermat) == 12_bn);
         }
     }
+
+    SECTION("Views") {
+        // limbs inside a bigger buffer, with a leading zero limb
+        const lab::Limb buffer[] = {42, 18446744073709551615ull, 5, 0, 12345678901234567890ull, 42};
+        const lab::BigNumView a(buffer + 1, 3);
+        const lab::BigNumView b(buffer + 4, 1);
+        const auto mod = 1000000007_bn;
+
+        REQUIRE(a.size() == 2);
+        REQUIRE(to_string(a) == "110680464442257309695");
+        REQUIRE(lab::BigNum(a) == 110680464442257309695_bn);
+        REQUIRE(b < a);
+        REQUIRE(a == 110680464442257309695_bn);
+        REQUIRE(12345678901234567890_bn == b);
+        REQUIRE(a + b == 123026143343491877585_bn);
+        REQUIRE(a - b == 98334785541022741805_bn);
+        REQUIRE(a * b == 1366425474643618884123024569167232693550_bn);
+        REQUIRE(a % b == 11915033232380766575_bn);
+        REQUIRE(add(a, b, mod) == 308880211_bn);
+        REQUIRE(subtract(b, a, mod) == 320752166_bn);
+        REQUIRE(multiply(a, b, mod) == 451509437_bn);
+
+        auto num = 1_bn;
+        num += a;
+        REQUIRE(num == 110680464442257309696_bn);
+    }
+
+    SECTION("Arena for temporaries") {
+        const lab::BigNum a(std::string(700, '9'));
+        lab::BigNum product;
+        {
+            std::pmr::monotonic_buffer_resource arena;
+            lab::LimbResourceScope scope(&arena);
+            product = a * a % 1000000000000000000000000000000_bn + inverted(a, 23321723123_bn, lab::BigNum::InversionPolicy::Euclid);
+        }
+        REQUIRE(product == 1_bn + inverted(a, 23321723123_bn, lab::BigNum::InversionPolicy::Euclid));
+    }
+
+    SECTION("Limb boundaries") {
+        const auto max_limb = 18446744073709551615_bn;
+
+        SECTION("carry") {
+            REQUIRE(max_limb + 1_bn == 18446744073709551616_bn);
+            REQUIRE(1_bn + max_limb == 18446744073709551616_bn);
+        }
+        SECTION("borrow") {
+            REQUIRE(18446744073709551616_bn - 1_bn == max_limb);
+            REQUIRE(340282366920938463463374607431768211456_bn - max_limb == 340282366920938463444927863358058659841_bn);
+        }
+        SECTION("product") {
+            REQUIRE(max_limb * max_limb == 340282366920938463426481119284349108225_bn);
+        }
+        SECTION("zero") {
+            REQUIRE(to_string(0_bn) == "0");
+            REQUIRE(max_limb - max_limb == 0_bn);
+        }
+    }
+}
+
+TEST_CASE("Fixed numbers test", "[FixedNum]") {
+    using Fixed256 = lab::FixedNum<256>;
+    using Fixed521 = lab::FixedNum<521>;
+
+    const auto max256 = 115792089237316195423570985008687907853269984665640564039457584007913129639935_bn;
+    const auto value = 100720434724302814904028779430100746620875123589040262858485383693240386628266_bn;
+
+    SECTION( "Conversion" ) {
+        REQUIRE(lab::BigNum(Fixed256(value)) == value);
+        REQUIRE(lab::BigNum(Fixed256()) == 0_bn);
+        REQUIRE_THROWS_AS(Fixed256(max256 + 1_bn), std::invalid_argument);
+        REQUIRE_THROWS_AS(lab::FixedNum<200>(max256), std::invalid_argument);
+    }
+
+    SECTION( "Add and subtract" ) {
+        const Fixed256 a(max256);
+        const Fixed256 b(value);
+        REQUIRE(lab::BigNum(a + b) == 100720434724302814904028779430100746620875123589040262858485383693240386628265_bn);
+        REQUIRE(lab::BigNum(a - b) == max256 - value);
+        REQUIRE(lab::BigNum(b - a) == value + 1_bn);
+        REQUIRE(a + Fixed256(1) == Fixed256());
+    }
+
+    SECTION( "Multiply" ) {
+        const Fixed256 a(max256);
+        const Fixed256 b(value);
+        REQUIRE(lab::BigNum(a * b) == max256 * value);
+
+        const Fixed521 p(6864797660130609714981900799081393217269435300143305409394463459185543183397656052122559640661454554977296311391480858037121987999716643812574028291115057151_bn);
+        REQUIRE(p + Fixed521(1) == Fixed521());
+        REQUIRE(lab::BigNum(p * p) == lab::BigNum(p) * lab::BigNum(p));
+    }
+
+    SECTION( "Compare" ) {
+        const Fixed256 a(max256);
+        const Fixed256 b(value);
+        REQUIRE(b < a);
+        REQUIRE(a > b);
+        REQUIRE(b <= b);
+        REQUIRE(a >= b);
+        REQUIRE(a != b);
+        REQUIRE(a == Fixed256(max256));
+        static_assert(lab::FixedNum<64>(3) < lab::FixedNum<64>(5));
+        static_assert(lab::FixedNum<64>(2) + lab::FixedNum<64>(3) == lab::FixedNum<64>(5));
+    }
 }
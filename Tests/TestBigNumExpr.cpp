@@ -0,0 +1,58 @@
+#include <BigNumExpr.hpp>
+
+#include "catch.hpp"
+#include "CountingResource.hpp"
+
+using lab::lazy;
+
+TEST_CASE("Big number expressions test", "[BigNumExpr]") {
+    const auto a = 4241229841928441249124921409124091221_bn;
+    const auto b = 12901092091309210942109410951309019490_bn;
+    const auto c = 340282366920938463463374607431768211455_bn;
+    const auto mod = 120130924091094109_bn;
+
+    SECTION( "Plain arithmetic" ) {
+        const lab::BigNum sum = lazy(a) + b + c;
+        REQUIRE(sum == a + b + c);
+
+        const lab::BigNum product = lazy(a) * b * c;
+        REQUIRE(product == a * b * c);
+
+        const lab::BigNum mixed = c - lazy(a) * 2_bn + b;
+        REQUIRE(mixed == c - a * 2_bn + b);
+    }
+
+    SECTION( "Modulo" ) {
+        const lab::BigNum product = (lazy(a) * b) % mod;
+        REQUIRE(product == 88191807529973443_bn);
+        REQUIRE(product == multiply(a, b, mod));
+
+        const lab::BigNum chain = (lazy(a) * b * c + a) % mod;
+        REQUIRE(chain == (a * b * c + a) % mod);
+
+        const lab::BigNum nested = (lazy(a) % mod * (lazy(b) % mod)) % mod;
+        REQUIRE(nested == product);
+    }
+
+    SECTION( "Modulo of curve size does not allocate" ) {
+        // modulus of secp256k1
+        const auto p = 115792089237316195423570985008687907853269984665640564039457584007908834671663_bn;
+        const auto x = p - 1234567_bn;
+        test::CountingResource counting;
+        lab::LimbResourceScope scope(&counting);
+        const lab::BigNum result = (lazy(x) * x - x + a) % p;
+        REQUIRE(counting.allocations == 0);
+        REQUIRE(result == (x * x - x + a) % p);
+    }
+
+    SECTION( "Modulo difference" ) {
+        const lab::BigNum difference = (lazy(a) - b) % mod;
+        REQUIRE(difference == subtract(a, b, mod));
+    }
+
+    SECTION( "Evaluate to destination" ) {
+        auto dest = a;
+        lab::expr::evaluate(dest, (lazy(dest) - lazy(b) * c) % mod);
+        REQUIRE(dest == subtract(a, b * c, mod));
+    }
+}
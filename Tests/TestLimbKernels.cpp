@@ -0,0 +1,102 @@
+#include <LimbKernels.hpp>
+#include <BigNum.hpp>
+#include <Limbs.hpp>
+
+#include <random>
+#include <vector>
+
+#include "catch.hpp"
+#include "RandomLimbs.hpp"
+
+using lab::Limb;
+using test::randomLimbs;
+using test::toNum;
+
+TEST_CASE("Limb kernels test", "[LimbKernels]") {
+    using lab::kernels::Variant;
+
+    const auto initial = lab::kernels::current();
+    REQUIRE(lab::kernels::isSupported(Variant::Portable));
+    REQUIRE(lab::kernels::isSupported(initial));
+
+    std::vector<Variant> variants{Variant::Portable};
+    if (lab::kernels::isSupported(Variant::Adx)) {
+        variants.push_back(Variant::Adx);
+    } else {
+        REQUIRE_THROWS_AS(lab::kernels::select(Variant::Adx), std::invalid_argument);
+    }
+
+    SECTION( "Variants give the same results" ) {
+        std::mt19937_64 generator(20);
+        for (std::size_t lhs_size = 1; lhs_size <= 40; lhs_size += 3) {
+            for (std::size_t rhs_size = 1; rhs_size <= 13; rhs_size += 4) {
+                const auto lhs = randomLimbs(generator, lhs_size);
+                const auto rhs = randomLimbs(generator, rhs_size);
+                const auto addend = randomLimbs(generator, lhs_size);
+
+                std::vector<std::vector<Limb>> products;
+                std::vector<std::vector<Limb>> sums;
+                std::vector<Limb> carries;
+                for (const auto variant : variants) {
+                    lab::kernels::select(variant);
+                    REQUIRE(lab::kernels::current() == variant);
+
+                    std::vector<Limb> product(lhs_size + rhs_size);
+                    lab::kernels::basecaseMultiplication(lhs.data(), lhs_size, rhs.data(), rhs_size, product.data());
+                    products.push_back(product);
+
+                    auto sum = addend;
+                    carries.push_back(lab::kernels::addmul_1(sum.data(), lhs.data(), lhs_size, rhs[0]));
+                    sums.push_back(sum);
+                }
+                for (std::size_t i = 1; i < variants.size(); ++i) {
+                    REQUIRE(products[i] == products[0]);
+                    REQUIRE(sums[i] == sums[0]);
+                    REQUIRE(carries[i] == carries[0]);
+                }
+                REQUIRE(toNum(products[0]) == toNum(lhs) * toNum(rhs));
+            }
+        }
+    }
+
+    SECTION( "Montgomery reduction" ) {
+        std::mt19937_64 generator(21);
+        for (std::size_t size = 1; size <= 6; ++size) {
+            auto mod = randomLimbs(generator, size);
+            mod[0] |= 1;
+            mod.back() |= Limb(1) << 63;
+            const Limb inverse = 0 - lab::mpn::binvert_limb(mod[0]);
+
+            std::vector<Limb> shift(size + 1);
+            shift.back() = 1;
+            // the biggest allowed number and a random one below it
+            const auto biggest = toNum(mod) * toNum(shift) - 1_bn;
+            std::vector<Limb> nums[] = {std::vector<Limb>(lab::BigNumView(biggest).begin(),
+                                                          lab::BigNumView(biggest).end()),
+                                        randomLimbs(generator, size * 2)};
+            nums[1].back() >>= 1;
+            for (auto& num : nums) {
+                num.resize(size * 2);
+                const auto original = toNum(num);
+                for (const auto variant : variants) {
+                    lab::kernels::select(variant);
+                    auto reduced = num;
+                    lab::kernels::montgomeryReduce(reduced.data(), mod.data(), size, inverse);
+                    const std::vector<Limb> result(reduced.begin() + size, reduced.end());
+                    REQUIRE(toNum(result) < toNum(mod));
+                    REQUIRE(toNum(result) * toNum(shift) % toNum(mod) == original % toNum(mod));
+                }
+            }
+        }
+    }
+
+    SECTION( "Power modulo odd number" ) {
+        for (const auto variant : variants) {
+            lab::kernels::select(variant);
+            REQUIRE(inverted(1442141324241124_bn, 1000003_bn, lab::BigNum::InversionPolicy::Fermat)
+                    == inverted(1442141324241124_bn, 1000003_bn, lab::BigNum::InversionPolicy::Euclid));
+        }
+    }
+
+    lab::kernels::select(initial);
+}
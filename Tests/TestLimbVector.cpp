@@ -0,0 +1,81 @@
+#include <LimbVector.hpp>
+
+#include "catch.hpp"
+#include "CountingResource.hpp"
+
+TEST_CASE("Limb vector test", "[LimbVector]") {
+    using Vector = lab::LimbVector<4>;
+
+    SECTION( "Inline storage" ) {
+        Vector limbs;
+        for (lab::Limb i = 0; i < 4; ++i) {
+            limbs.push_back(i);
+        }
+        REQUIRE(limbs.isInline());
+        REQUIRE(limbs.size() == 4);
+        REQUIRE(limbs.back() == 3);
+    }
+
+    SECTION( "Spill to heap" ) {
+        Vector limbs(4, 7);
+        limbs.push_back(8);
+        REQUIRE(!limbs.isInline());
+        REQUIRE(limbs.size() == 5);
+        REQUIRE(limbs[0] == 7);
+        REQUIRE(limbs[4] == 8);
+
+        limbs.resize(2);
+        REQUIRE(limbs.size() == 2);
+        REQUIRE(limbs.capacity() >= 5);
+    }
+
+    SECTION( "Copy and move" ) {
+        SECTION( "inline" ) {
+            Vector limbs(3, 1);
+            Vector copy = limbs;
+            Vector moved = std::move(limbs);
+            REQUIRE(copy == moved);
+            REQUIRE(moved.isInline());
+            REQUIRE(limbs.empty());
+        }
+        SECTION( "heap" ) {
+            Vector limbs(10, 1);
+            const auto* buffer = limbs.data();
+            Vector copy = limbs;
+            Vector moved = std::move(limbs);
+            REQUIRE(copy == moved);
+            REQUIRE(moved.data() == buffer);
+            REQUIRE(limbs.isInline());
+
+            copy = Vector(2, 5);
+            REQUIRE(copy == Vector(2, 5));
+        }
+    }
+
+    SECTION( "Memory resource" ) {
+        test::CountingResource counting;
+
+        SECTION( "explicit" ) {
+            Vector limbs(&counting);
+            limbs.resize(3);
+            REQUIRE(counting.allocations == 0);
+            limbs.resize(10);
+            REQUIRE(counting.allocations == 1);
+            REQUIRE(limbs.resource() == &counting);
+        }
+        SECTION( "scope" ) {
+            Vector outside;
+            {
+                lab::LimbResourceScope scope(&counting);
+                Vector inside(10, 1);
+                REQUIRE(inside.resource() == &counting);
+                REQUIRE(counting.allocations == 1);
+
+                outside = std::move(inside);
+                REQUIRE(outside.resource() != &counting);
+                REQUIRE(outside == Vector(10, 1));
+            }
+            REQUIRE(lab::LimbResourceScope::current() == std::pmr::get_default_resource());
+        }
+    }
+}
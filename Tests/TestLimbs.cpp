@@ -0,0 +1,155 @@
+#include <Limbs.hpp>
+
+#include <vector>
+
+#include "catch.hpp"
+
+TEST_CASE("Limb primitives test", "[Limbs]") {
+    using lab::Limb;
+    constexpr Limb MAX = ~Limb(0);
+
+    SECTION( "Add" ) {
+        std::vector<Limb> lhs{MAX, MAX, 5, 0};
+        const std::vector<Limb> rhs{1, 0, MAX, MAX};
+        std::vector<Limb> result(4);
+        REQUIRE(lab::mpn::add_n(result.data(), lhs.data(), rhs.data(), 4) == 1);
+        REQUIRE(result == std::vector<Limb>{0, 0, 5, 0});
+
+        // in place, carry goes through every limb
+        REQUIRE(lab::mpn::add_n(lhs.data(), lhs.data(), rhs.data(), 2) == 1);
+        REQUIRE(lhs == std::vector<Limb>{0, 0, 5, 0});
+        REQUIRE(lab::mpn::add_n(result.data(), lhs.data(), rhs.data(), 0) == 0);
+
+        std::vector<Limb> ones{MAX, MAX, 7};
+        REQUIRE(lab::mpn::add_1(ones.data(), ones.data(), 3, 1) == 0);
+        REQUIRE(ones == std::vector<Limb>{0, 0, 8});
+        REQUIRE(lab::mpn::add_1(result.data(), ones.data(), 3, 0) == 0);
+        REQUIRE(std::vector<Limb>(result.begin(), result.begin() + 3) == ones);
+        ones = {MAX, MAX};
+        REQUIRE(lab::mpn::add_1(ones.data(), ones.data(), 2, 1) == 1);
+    }
+
+    SECTION( "Subtract" ) {
+        const std::vector<Limb> lhs{0, 0, 5, 0};
+        const std::vector<Limb> rhs{1, 0, MAX, MAX};
+        std::vector<Limb> result(4);
+        REQUIRE(lab::mpn::sub_n(result.data(), lhs.data(), rhs.data(), 4) == 1);
+        REQUIRE(result == std::vector<Limb>{MAX, MAX, 5, 0});
+
+        // subtrahend may be the result too
+        result = {1, 0, 4, 0};
+        REQUIRE(lab::mpn::sub_n(result.data(), lhs.data(), result.data(), 4) == 0);
+        REQUIRE(result == std::vector<Limb>{MAX, MAX, 0, 0});
+
+        std::vector<Limb> num{0, 0, 8};
+        REQUIRE(lab::mpn::sub_1(num.data(), num.data(), 3, 1) == 0);
+        REQUIRE(num == std::vector<Limb>{MAX, MAX, 7});
+        num = {0, 0};
+        REQUIRE(lab::mpn::sub_1(num.data(), num.data(), 2, 1) == 1);
+    }
+
+    SECTION( "Compare" ) {
+        const std::vector<Limb> lhs{0, 5, MAX};
+        const std::vector<Limb> rhs{MAX, 4, MAX};
+        REQUIRE(lab::mpn::cmp(lhs.data(), rhs.data(), 3) > 0);
+        REQUIRE(lab::mpn::cmp(rhs.data(), lhs.data(), 3) < 0);
+        // only the given low limbs are compared
+        REQUIRE(lab::mpn::cmp(lhs.data(), rhs.data(), 1) < 0);
+        REQUIRE(lab::mpn::cmp(lhs.data() + 2, rhs.data() + 2, 1) == 0);
+        REQUIRE(lab::mpn::cmp(lhs.data(), rhs.data(), 0) == 0);
+    }
+
+    SECTION( "Multiply by limb" ) {
+        const std::vector<Limb> num{MAX, MAX, MAX};
+        std::vector<Limb> result(3);
+        // (2^192 - 1) * (2^64 - 1) = 2^256 - 2^192 - 2^64 + 1
+        REQUIRE(lab::mpn::mul_1(result.data(), num.data(), 3, MAX) == MAX - 1);
+        REQUIRE(result == std::vector<Limb>{1, MAX, MAX});
+
+        // (2^192 - 1) + (2^192 - 1) * (2^64 - 1) = 2^256 - 2^64
+        result = num;
+        REQUIRE(lab::mpn::addmul_1(result.data(), num.data(), 3, MAX) == MAX);
+        REQUIRE(result == std::vector<Limb>{0, MAX, MAX});
+
+        result = {0, 0, 0};
+        REQUIRE(lab::mpn::submul_1(result.data(), num.data(), 3, MAX) == MAX);
+        REQUIRE(result == std::vector<Limb>{MAX, 0, 0});
+
+        // the product is subtracted exactly, back to where it began
+        REQUIRE(lab::mpn::addmul_1(result.data(), num.data(), 3, MAX) == MAX);
+        REQUIRE(result == std::vector<Limb>{0, 0, 0});
+    }
+
+    SECTION( "Columns" ) {
+        // (2^128 - 1)^2 = 2^256 - 2^129 + 1
+        const std::vector<Limb> ones{MAX, MAX};
+        std::vector<Limb> result(4);
+        lab::mpn::ColumnSum sum;
+        lab::mpn::mul_columns(ones.data(), 2, ones.data(), 2, 0, 3, sum, result.data());
+        result[3] = sum.next();
+        REQUIRE(result == std::vector<Limb>{1, 0, MAX - 1, MAX});
+
+        // the upper columns alone go from the start of result, given the carry of the lowest one
+        sum.low = MAX - 1;
+        lab::mpn::mul_columns(ones.data(), 2, ones.data(), 2, 1, 3, sum, result.data());
+        REQUIRE(result[0] == 0);
+        REQUIRE(result[1] == MAX - 1);
+        REQUIRE(sum.next() == MAX);
+    }
+
+    SECTION( "Divide by limb" ) {
+        // (2^192 - 1) / (2^64 - 1) = 2^128 + 2^64 + 1
+        const std::vector<Limb> ones{MAX, MAX, MAX};
+        std::vector<Limb> quotient(3);
+        REQUIRE(lab::mpn::divrem_1(quotient.data(), ones.data(), 3, MAX) == 0);
+        REQUIRE(quotient == std::vector<Limb>{1, 1, 1});
+        REQUIRE(lab::mpn::invert_limb(MAX) == 1);
+        REQUIRE(lab::mpn::invert_limb(Limb(1) << 63) == MAX);
+        // inverses modulo 2^64 of odd limbs
+        REQUIRE(lab::mpn::binvert_limb(1) == 1);
+        REQUIRE(lab::mpn::binvert_limb(MAX) == MAX);
+        REQUIRE(lab::mpn::binvert_limb(3) * 3 == 1);
+        REQUIRE(lab::mpn::binvert_limb(0x9e3779b97f4a7c15ull) * 0x9e3779b97f4a7c15ull == 1);
+
+        // divisors with the top bit clear are shifted, 2^128 + 5 = 3 * (2^128 + 5) / 3
+        std::vector<Limb> num{5, 0, 1};
+        REQUIRE(lab::mpn::divrem_1(num.data(), num.data(), 3, 3) == 0);
+        REQUIRE(num == std::vector<Limb>{0x5555555555555557ull, 0x5555555555555555ull, 0});
+        num = {10, 0, 1};
+        // 2^128 = 4 modulo 9
+        REQUIRE(lab::mpn::divrem_1(quotient.data(), num.data(), 3, 9) == (4 + 10) % 9);
+        REQUIRE(lab::mpn::divrem_1(quotient.data(), num.data(), 1, 1) == 0);
+        REQUIRE(quotient[0] == 10);
+
+        // remainder alone, divisors with the top bit set reduce the top limb by a subtraction
+        REQUIRE(lab::mpn::mod_1(num.data(), 3, 9) == (4 + 10) % 9);
+        REQUIRE(lab::mpn::mod_1(ones.data(), 3, MAX) == 0);
+        REQUIRE(lab::mpn::mod_1(ones.data(), 1, MAX - 1) == 1);
+        REQUIRE(lab::mpn::mod_1(ones.data(), 3, Limb(1) << 63) == MAX >> 1);
+        const Limb odd = (Limb(1) << 63) + 12345;
+        REQUIRE(lab::mpn::mod_1(ones.data(), 3, odd) == lab::mpn::divrem_1(quotient.data(), ones.data(), 3, odd));
+        REQUIRE(lab::mpn::mod_1(ones.data(), 0, 7) == 0);
+
+        Limb rest = 0;
+        REQUIRE(lab::mpn::divrem_2by1(MAX - 1, MAX, MAX, lab::mpn::invert_limb(MAX), rest) == MAX);
+        REQUIRE(rest == MAX - 1);
+    }
+
+    SECTION( "Shift" ) {
+        std::vector<Limb> num{0x8000000000000001ull, 0x8000000000000000ull, 3};
+        std::vector<Limb> result(3);
+        REQUIRE(lab::mpn::lshift(result.data(), num.data(), 3, 1) == 0);
+        REQUIRE(result == std::vector<Limb>{2, 1, 7});
+        REQUIRE(lab::mpn::lshift(result.data(), num.data(), 3, 63) == 1);
+        REQUIRE(result == std::vector<Limb>{0x8000000000000000ull, 0x4000000000000000ull, 0xC000000000000000ull});
+
+        REQUIRE(lab::mpn::rshift(result.data(), num.data(), 3, 1) == 0x8000000000000000ull);
+        REQUIRE(result == std::vector<Limb>{0x4000000000000000ull, 0xC000000000000000ull, 1});
+
+        // in place there and back again
+        const auto copy = num;
+        REQUIRE(lab::mpn::lshift(num.data(), num.data(), 3, 4) == 0);
+        REQUIRE(lab::mpn::rshift(num.data(), num.data(), 3, 4) == 0);
+        REQUIRE(num == copy);
+    }
+}
@@ -0,0 +1,51 @@
+#include <ThreadPool.hpp>
+
+#include <atomic>
+#include <stdexcept>
+
+#include "catch.hpp"
+
+TEST_CASE("Thread pool test", "[ThreadPool]") {
+    SECTION( "Runs every task" ) {
+        lab::ThreadPool pool(3);
+        std::atomic<int> sum(0);
+        std::vector<lab::ThreadPool::Task> tasks;
+        for (int i = 1; i <= 100; ++i) {
+            tasks.emplace_back([&sum, i] { sum += i; });
+        }
+        pool.forkJoin(std::move(tasks));
+        REQUIRE(sum == 5050);
+    }
+
+    SECTION( "Nested forks" ) {
+        lab::ThreadPool pool(2);
+        std::atomic<int> leaves(0);
+        std::function<void(int)> fork = [&](int depth) {
+            if (depth == 0) {
+                ++leaves;
+                return;
+            }
+            pool.forkJoin({[&, depth] { fork(depth - 1); }, [&, depth] { fork(depth - 1); }});
+        };
+        fork(8);
+        REQUIRE(leaves == 256);
+    }
+
+    SECTION( "Without workers" ) {
+        lab::ThreadPool pool(0);
+        int count = 0;
+        pool.forkJoin({[&count] { ++count; }, [&count] { ++count; }});
+        REQUIRE(count == 2);
+        REQUIRE(pool.workers() == 0);
+    }
+
+    SECTION( "Exception" ) {
+        lab::ThreadPool pool(2);
+        std::atomic<int> finished(0);
+        REQUIRE_THROWS_AS(pool.forkJoin({[&finished] { ++finished; },
+                                         [] { throw std::runtime_error("task failed"); },
+                                         [&finished] { ++finished; }}),
+                          std::runtime_error);
+        REQUIRE(finished == 2);
+    }
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <BigNum.hpp>
+
+namespace test {
+    /**
+     * @brief Restores thresholds active at its construction when it goes out of scope,
+     *        so that a failed check does not leave the following tests with changed ones
+     */
+    class ThresholdsGuard {
+    public:
+        ThresholdsGuard()
+            : _saved(lab::Thresholds::current()) {
+        }
+
+        ThresholdsGuard(const ThresholdsGuard&) = delete;
+        ThresholdsGuard& operator=(const ThresholdsGuard&) = delete;
+
+        ~ThresholdsGuard() {
+            lab::Thresholds::set(_saved);
+        }
+
+        const lab::Thresholds& saved() const {
+            return _saved;
+        }
+
+    private:
+        lab::Thresholds _saved;
+    };
+}
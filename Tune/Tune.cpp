@@ -0,0 +1,202 @@
+#include <BigNum.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using lab::Thresholds;
+
+constexpr std::size_t NEVER = Thresholds::OFF;
+
+/**
+ * @brief Number of consecutive sizes faster method must win at to be chosen,
+ *        so that a single noisy measurement does not move threshold
+ */
+constexpr int WINS_IN_ROW = 2;
+
+lab::BigNum randomNum(std::size_t limbs, std::mt19937_64& generator) {
+    std::vector<lab::Limb> data(limbs);
+    std::generate(data.begin(), data.end(), std::ref(generator));
+    data.back() |= 1;
+    return lab::BigNum(lab::BigNumView(data.data(), data.size()));
+}
+
+/**
+ * @return Best of several runs of time of a single operation in seconds
+ */
+template <typename Operation>
+double timeOperation(const Operation& operation, const Thresholds& thresholds) {
+    using Clock = std::chrono::steady_clock;
+    Thresholds::set(thresholds);
+    auto result = operation();
+
+    double best = std::numeric_limits<double>::max();
+    for (int run = 0; run < 5; ++run) {
+        int repeats = 0;
+        const auto start = Clock::now();
+        std::chrono::duration<double> elapsed{};
+        do {
+            result = operation();
+            ++repeats;
+            elapsed = Clock::now() - start;
+        } while (elapsed.count() < 0.002);
+        best = std::min(best, elapsed.count() / repeats);
+    }
+    return best;
+}
+
+/**
+ * @return Product of random numbers of given size
+ */
+auto randomProduct(std::size_t size, std::mt19937_64& generator) {
+    return [lhs = randomNum(size, generator), rhs = randomNum(size, generator)] { return lhs * rhs; };
+}
+
+/**
+ * @return Division of random number of twice given size by one of given size
+ */
+auto randomDivision(std::size_t size, std::mt19937_64& generator) {
+    return [num = randomNum(size * 2, generator), divisor = randomNum(size, generator)] {
+        return extract(num, divisor);
+    };
+}
+
+/**
+ * @brief Times operations on random numbers of given sizes by slow method and by fast one
+ * @param operation makes operation on random numbers of given size
+ * @param fast returns thresholds which make fast method split operands of given size
+ * @return The smallest size from which fast method wins, or NEVER if it wins at none of them
+ */
+template <typename Operation, typename Fast>
+std::size_t crossover(Operation operation, const std::vector<std::size_t>& sizes,
+                      const Thresholds& slow, Fast fast) {
+    std::mt19937_64 generator(sizes.front());
+    int wins = 0;
+    for (std::size_t i = 0; i < sizes.size(); ++i) {
+        const auto run = operation(sizes[i], generator);
+        const double slow_time = timeOperation(run, slow);
+        const double fast_time = timeOperation(run, fast(sizes[i]));
+        std::cout << "  " << sizes[i] << " limbs: " << slow_time * 1e6 << " us vs " << fast_time * 1e6 << " us\n";
+
+        wins = fast_time < slow_time ? wins + 1 : 0;
+        if (wins == WINS_IN_ROW) {
+            return sizes[i + 1 - WINS_IN_ROW];
+        }
+    }
+    return NEVER;
+}
+
+/**
+ * @return Threshold as C++ expression for generated header
+ */
+std::string thresholdText(std::size_t threshold) {
+    return threshold == NEVER ? "std::numeric_limits<std::size_t>::max()" : std::to_string(threshold);
+}
+
+std::vector<std::size_t> geometricSizes(std::size_t from, std::size_t to, double step) {
+    std::vector<std::size_t> sizes;
+    for (double size = from; size <= to; size *= step) {
+        if (sizes.empty() || sizes.back() != static_cast<std::size_t>(size)) {
+            sizes.push_back(static_cast<std::size_t>(size));
+        }
+    }
+    return sizes;
+}
+
+} // namespace
+
+/**
+ * @brief Measures multiplication and division thresholds on current machine and writes them
+ *        as header in format of Src/Thresholds.hpp.in to the path from arguments
+ */
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        std::cerr << "Usage: " << argv[0] << " <output header>\n";
+        return 1;
+    }
+
+    std::cout << "Naive multiplication vs Karatsuba\n";
+    std::vector<std::size_t> sizes;
+    for (std::size_t size = 8; size <= 160; size += 4) {
+        sizes.push_back(size);
+    }
+    std::size_t karatsuba = crossover(randomProduct, sizes, {},
+        [](std::size_t size) { return Thresholds{size - 1}; });
+    if (karatsuba != NEVER) {
+        --karatsuba;
+    }
+
+    std::cout << "Karatsuba vs Toom-3\n";
+    const std::size_t toom3 = crossover(randomProduct,
+                                        geometricSizes(std::clamp<std::size_t>(karatsuba, 16, 1000) * 2, 2000, 1.1),
+                                        {karatsuba},
+        [karatsuba](std::size_t size) { return Thresholds{karatsuba, size}; });
+
+    std::cout << "Toom-3 vs number-theoretic transform\n";
+    const std::size_t ntt = crossover(randomProduct, geometricSizes(1000, 60000, 1.2),
+                                      {karatsuba, toom3},
+        [karatsuba, toom3](std::size_t size) { return Thresholds{karatsuba, toom3, size}; });
+
+    std::cout << "Serial vs parallel products\n";
+    const std::size_t parallel = crossover(randomProduct, geometricSizes(200, 40000, 1.5),
+                                           {karatsuba, toom3, ntt},
+        [karatsuba, toom3, ntt](std::size_t size) { return Thresholds{karatsuba, toom3, ntt, size}; });
+
+    std::cout << "Schoolbook vs recursive division\n";
+    const std::size_t division = crossover(randomDivision, geometricSizes(8, 1000, 1.15),
+                                           {karatsuba, toom3, ntt, parallel},
+        [karatsuba, toom3, ntt, parallel](std::size_t size) {
+            return Thresholds{karatsuba, toom3, ntt, parallel, size};
+        });
+
+    std::cout << "Recursive division vs Newton's reciprocal\n";
+    const std::size_t newton = crossover(randomDivision, geometricSizes(4000, 240000, 1.5),
+                                         {karatsuba, toom3, ntt, parallel, division},
+        [karatsuba, toom3, ntt, parallel, division](std::size_t size) {
+            return Thresholds{karatsuba, toom3, ntt, parallel, division, size};
+        });
+
+    std::ofstream header(argv[1]);
+    header << "#pragma once\n"
+              "\n"
+              "#include <cstddef>\n"
+              "#include <limits>\n"
+              "\n"
+              "namespace lab {\n"
+              "\n"
+              "/**\n"
+              " * @brief Sizes in limbs from which multiplication and division switch to faster methods,\n"
+              " *        generated by `tune` target on this machine\n"
+              " */\n"
+           << "constexpr std::size_t MIN_FOR_KARATSUBA = " << thresholdText(karatsuba) << ";\n"
+           << "constexpr std::size_t MIN_FOR_TOOM3 = " << thresholdText(toom3) << ";\n"
+           << "constexpr std::size_t MIN_FOR_NTT = " << thresholdText(ntt) << ";\n"
+           << "constexpr std::size_t MIN_FOR_PARALLEL = " << thresholdText(parallel) << ";\n"
+           << "constexpr std::size_t MIN_FOR_DIVISION = " << thresholdText(division) << ";\n"
+           << "constexpr std::size_t MIN_FOR_NEWTON = " << thresholdText(newton) << ";\n"
+           << "\n"
+              "} // namespace lab\n";
+    if (!header) {
+        std::cerr << "Could not write " << argv[1] << "\n";
+        return 1;
+    }
+
+    const auto describe = [](const char* method, std::size_t threshold, const char* direction) {
+        return threshold == NEVER ? std::string(method) + " never"
+                                  : std::string(method) + direction + std::to_string(threshold) + " limbs";
+    };
+    std::cout << describe("Karatsuba", karatsuba, " above ") << ", " << describe("Toom-3", toom3, " from ") << ", "
+              << describe("number-theoretic transform", ntt, " from ") << ", "
+              << describe("parallel products", parallel, " from ") << ", "
+              << describe("recursive division", division, " from ") << ", "
+              << describe("division by reciprocal", newton, " from ") << "\n"
+              << "Written to " << argv[1] << ", rebuild to use them\n";
+    return 0;
+}